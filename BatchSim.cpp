@@ -0,0 +1,355 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the BatchSim class.
+******************************************************************************************************************************************************/
+#include "BatchSim.hpp"
+
+#include <cstring>
+
+//The AVX2 kernel is only built for x86. Elsewhere avx2_available() is false and every batch runs step_scalar().
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCHSIM_X86
+#include <immintrin.h>
+#endif
+
+const int BatchSim::MAX_CELLS;
+const int BatchSim::PIECES;
+const uint8_t BatchSim::BLOCKED;
+const uint8_t BatchSim::VAULT;
+const int BatchSim::PLAYING, BatchSim::LOST, BatchSim::WON, BatchSim::IDLE;
+
+/*****************************************************************************************************************************************************
+** next_draw(uint32_t& state)
+** One step of a xorshift32 generator. Both kernels draw four numbers per lane per step, in the same order.
+******************************************************************************************************************************************************/
+static inline uint32_t next_draw(uint32_t& state){
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+//A number in [0, range) from the top 16 bits of a draw
+static inline int32_t scale_draw(uint32_t draw, int32_t range){
+    return int32_t(((draw >> 16) * uint32_t(range)) >> 16);
+}
+
+/*****************************************************************************************************************************************************
+** BatchSim constructor
+** Flattens every template: the destination of each move ignoring portals (BLOCKED for a mountain or the edge) and
+** the list of open cells the pieces are placed on.
+******************************************************************************************************************************************************/
+BatchSim::BatchSim(const std::vector<MapTemplate>& maps, int lanes, unsigned seed, int starting_strength,
+                   int max_moves, Kernel kernel) : rd(seed){
+
+    this->lanes = (std::max(lanes, 1) + 7) / 8 * 8;
+    this->starting_strength = starting_strength;
+    this->max_moves = max_moves;
+    this->kernel = (kernel == AVX2 && avx2_available()) ? AVX2 : SCALAR;
+
+    for (const MapTemplate& map : maps){
+        Layout layout;
+        layout.cells = map.rows * map.cols;
+        if (layout.cells > MAX_CELLS){
+            throw string("ERROR: BatchSim supports boards of at most 64 cells\n");
+        }
+
+        Grid grid(map.rows, map.cols);
+        layout.moves.assign(layout.cells * NUM_DIRECTIONS, BLOCKED);
+        for (int cell = 0; cell < layout.cells; cell++){
+            if (map.cells[cell] == 'A'){
+                continue;
+            }
+            layout.open.push_back(cell);
+            for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+                int next = grid.neighbour(cell, dir);
+                if (next >= 0 && map.cells[next] != 'A'){
+                    layout.moves[cell * NUM_DIRECTIONS + dir] = next;
+                }
+            }
+        }
+        if (layout.open.size() < (size_t)PIECES){
+            throw string("ERROR: BatchSim needs at least 13 open cells on every board\n");
+        }
+        layouts.push_back(layout);
+    }
+
+    destination.assign(this->lanes * MAX_CELLS * NUM_DIRECTIONS + 4, BLOCKED);
+    kind.assign(this->lanes * MAX_CELLS + 4, 0);
+
+    position.assign(this->lanes, 0);
+    strength.assign(this->lanes, 0);
+    keys.assign(this->lanes, 0);
+    fought.assign(this->lanes, 0);
+    moves.assign(this->lanes, 0);
+    status.assign(this->lanes, IDLE);
+    map_id.assign(this->lanes, 0);
+
+    //xorshift32 must not start at 0
+    dice.resize(this->lanes);
+    for (uint32_t& state : dice){
+        do {
+            state = rd();
+        } while (state == 0);
+    }
+
+    games.assign(maps.size(), 0);
+    wins.assign(maps.size(), 0);
+}
+
+/*****************************************************************************************************************************************************
+** bool avx2_available()
+******************************************************************************************************************************************************/
+bool BatchSim::avx2_available(){
+#ifdef BATCHSIM_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+/*****************************************************************************************************************************************************
+** setup_lane(int lane)
+** Starts a new game on "lane": picks a template, places the pieces on random open cells, and links the portals by
+** sending every move onto one portal to its partner. Moving from a cell in direction "dir" reaches the cell that is
+** in direction 7 - dir from it, because DIRECTIONS lists opposite directions at mirrored positions.
+******************************************************************************************************************************************************/
+void BatchSim::setup_lane(int lane){
+    int id = std::uniform_int_distribution<int>{0, (int)layouts.size() - 1}(rd);
+    const Layout& layout = layouts[id];
+
+    uint8_t* dest = &destination[lane * MAX_CELLS * NUM_DIRECTIONS];
+    uint8_t* kinds = &kind[lane * MAX_CELLS];
+    std::memcpy(dest, layout.moves.data(), layout.moves.size());
+    std::memset(kinds, 0, MAX_CELLS);
+
+    //Partial shuffle: the first PIECES open cells become the start, vault, portals and enemies
+    shuffled.assign(layout.open.begin(), layout.open.end());
+    for (int piece = 0; piece < PIECES; piece++){
+        int other = std::uniform_int_distribution<int>{piece, (int)shuffled.size() - 1}(rd);
+        std::swap(shuffled[piece], shuffled[other]);
+    }
+
+    kinds[shuffled[1]] = VAULT;
+    for (int enemy = 0; enemy < PIECES - 4; enemy++){
+        kinds[shuffled[4 + enemy]] = enemy + 1;
+    }
+
+    for (int side = 0; side < 2; side++){
+        int portal = shuffled[2 + side], partner = shuffled[3 - side];
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+            int from = layout.moves[portal * NUM_DIRECTIONS + dir];
+            if (from != BLOCKED){
+                dest[from * NUM_DIRECTIONS + (NUM_DIRECTIONS - 1 - dir)] = partner;
+            }
+        }
+    }
+
+    position[lane] = shuffled[0];
+    strength[lane] = starting_strength;
+    keys[lane] = 0;
+    fought[lane] = 0;
+    moves[lane] = 0;
+    status[lane] = PLAYING;
+    map_id[lane] = id;
+}
+
+/*****************************************************************************************************************************************************
+** run(long count)
+******************************************************************************************************************************************************/
+void BatchSim::run(long count){
+    long started = 0, finished = 0;
+    for (int lane = 0; lane < lanes; lane++){
+        if (started < count){
+            setup_lane(lane);
+            started++;
+        }
+        else {
+            status[lane] = IDLE;
+        }
+    }
+
+    while (finished < count){
+        if (kernel == AVX2){
+            step_avx2();
+        }
+        else {
+            step_scalar();
+        }
+
+        for (int lane = 0; lane < lanes; lane++){
+            if (status[lane] != LOST && status[lane] != WON){
+                continue;
+            }
+            games[map_id[lane]]++;
+            wins[map_id[lane]] += (status[lane] == WON);
+            finished++;
+
+            if (started < count){
+                setup_lane(lane);
+                started++;
+            }
+            else {
+                status[lane] = IDLE;
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** step_scalar()
+** One move of every game still being played:
+    - A move into a mountain or off the board costs nothing and leaves the player in place.
+    - Any other move costs 1 strength point (a portal's partner is already the destination).
+    - The vault wins the game if the player holds 4 keys.
+    - An enemy not yet fought starts a battle if the player holds fewer than 4 keys and has strength left: its
+      maximum power is 6-10, its attack 1 to that maximum, and the wager 1 to that maximum. The wager is lost, and
+      if it is at least the attack, the player gains a key and recovers half of it.
+    - The game ends when the player wins, runs out of strength, or reaches the move limit.
+******************************************************************************************************************************************************/
+void BatchSim::step_scalar(){
+    for (int lane = 0; lane < lanes; lane++){
+        if (status[lane] != PLAYING){
+            continue;
+        }
+
+        uint32_t move_draw = next_draw(dice[lane]), power_draw = next_draw(dice[lane]),
+                 attack_draw = next_draw(dice[lane]), wager_draw = next_draw(dice[lane]);
+
+        int dir = (move_draw >> 8) & 7;
+        int next = destination[lane * MAX_CELLS * NUM_DIRECTIONS + position[lane] * NUM_DIRECTIONS + dir];
+        moves[lane]++;
+        bool won = false;
+
+        if (next != BLOCKED){
+            position[lane] = next;
+            strength[lane]--;
+
+            int cell_kind = kind[lane * MAX_CELLS + next];
+            if (cell_kind == VAULT){
+                won = (keys[lane] >= 4);
+            }
+            else if (cell_kind && !(fought[lane] & (1 << (cell_kind - 1))) && keys[lane] < 4 && strength[lane] > 0){
+                int enemy_strength = 6 + scale_draw(power_draw, 5);
+                int enemy_attack = 1 + scale_draw(attack_draw, enemy_strength);
+                int wager = 1 + scale_draw(wager_draw, enemy_strength);
+
+                strength[lane] = std::max(strength[lane] - wager, 0);
+                if (wager >= enemy_attack){
+                    keys[lane]++;
+                    strength[lane] += wager / 2;
+                }
+                fought[lane] |= 1 << (cell_kind - 1);
+            }
+        }
+
+        if (won){
+            status[lane] = WON;
+        }
+        else if (strength[lane] == 0 || moves[lane] >= max_moves){
+            status[lane] = LOST;
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** step_avx2()
+** Same as step_scalar(), eight lanes at a time. Every branch becomes a mask, and the table lookups become gathers
+** of four bytes at a time, of which only the lowest is kept. Never chosen off x86, where it is step_scalar().
+******************************************************************************************************************************************************/
+#ifdef BATCHSIM_X86
+__attribute__((target("avx2")))
+void BatchSim::step_avx2(){
+    const __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi32(1), three = _mm256_set1_epi32(3),
+                  byte = _mm256_set1_epi32(0xFF), blocked = _mm256_set1_epi32(BLOCKED), vault = _mm256_set1_epi32(VAULT),
+                  six = _mm256_set1_epi32(6), five = _mm256_set1_epi32(5), enemies = _mm256_set1_epi32(PIECES - 3),
+                  limit = _mm256_set1_epi32(max_moves - 1), won_status = _mm256_set1_epi32(WON),
+                  lost_status = _mm256_set1_epi32(LOST), lane_step = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    const int* destinations = reinterpret_cast<const int*>(destination.data());
+    const int* kinds = reinterpret_cast<const int*>(kind.data());
+
+    for (int first = 0; first < lanes; first += 8){
+        __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&status[first]));
+        __m256i playing = _mm256_cmpeq_epi32(state, zero);
+        if (_mm256_testz_si256(playing, playing)){
+            continue;
+        }
+
+        //Four xorshift32 draws per lane, kept only for lanes still playing
+        __m256i draw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&dice[first])), draws[4];
+        for (int index = 0; index < 4; index++){
+            draw = _mm256_xor_si256(draw, _mm256_slli_epi32(draw, 13));
+            draw = _mm256_xor_si256(draw, _mm256_srli_epi32(draw, 17));
+            draw = _mm256_xor_si256(draw, _mm256_slli_epi32(draw, 5));
+            draws[index] = draw;
+        }
+        __m256i old_draw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&dice[first]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dice[first]), _mm256_blendv_epi8(old_draw, draw, playing));
+
+        __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(first), lane_step);
+        __m256i pos = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&position[first]));
+        __m256i points = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&strength[first]));
+        __m256i held = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&keys[first]));
+        __m256i beaten = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&fought[first]));
+        __m256i made = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&moves[first]));
+
+        //Look up the destination of the move
+        __m256i dir = _mm256_and_si256(_mm256_srli_epi32(draws[0], 8), _mm256_set1_epi32(7));
+        __m256i slot = _mm256_add_epi32(_mm256_slli_epi32(lane, 9), _mm256_add_epi32(_mm256_slli_epi32(pos, 3), dir));
+        __m256i next = _mm256_and_si256(_mm256_i32gather_epi32(destinations, slot, 1), byte);
+        __m256i moved = _mm256_andnot_si256(_mm256_cmpeq_epi32(next, blocked), playing);
+
+        pos = _mm256_blendv_epi8(pos, next, moved);
+        points = _mm256_add_epi32(points, moved);                   //moved is -1 in lanes that moved
+        made = _mm256_sub_epi32(made, playing);
+
+        //What is on the new cell
+        __m256i cell = _mm256_add_epi32(_mm256_slli_epi32(lane, 6), pos);
+        __m256i cell_kind = _mm256_and_si256(_mm256_i32gather_epi32(kinds, cell, 1), byte);
+        __m256i four_keys = _mm256_cmpgt_epi32(held, three);
+
+        __m256i won = _mm256_and_si256(moved, _mm256_and_si256(_mm256_cmpeq_epi32(cell_kind, vault), four_keys));
+
+        __m256i is_enemy = _mm256_and_si256(_mm256_cmpgt_epi32(cell_kind, zero), _mm256_cmpgt_epi32(enemies, cell_kind));
+        __m256i enemy_bit = _mm256_sllv_epi32(one, _mm256_sub_epi32(cell_kind, one));
+        __m256i unfought = _mm256_cmpeq_epi32(_mm256_and_si256(beaten, enemy_bit), zero);
+        __m256i battle = _mm256_and_si256(_mm256_and_si256(moved, is_enemy),
+                         _mm256_andnot_si256(four_keys, _mm256_and_si256(unfought, _mm256_cmpgt_epi32(points, zero))));
+
+        //The battle, computed for every lane and kept where there was one
+        __m256i enemy_strength = _mm256_add_epi32(six,
+                                 _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(draws[1], 16), five), 16));
+        __m256i enemy_attack = _mm256_add_epi32(one,
+                               _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(draws[2], 16), enemy_strength), 16));
+        __m256i wager = _mm256_add_epi32(one,
+                        _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(draws[3], 16), enemy_strength), 16));
+
+        __m256i victory = _mm256_and_si256(battle, _mm256_andnot_si256(_mm256_cmpgt_epi32(enemy_attack, wager), playing));
+        __m256i after = _mm256_max_epi32(_mm256_sub_epi32(points, wager), zero);
+        after = _mm256_add_epi32(after, _mm256_and_si256(victory, _mm256_srli_epi32(wager, 1)));
+
+        points = _mm256_blendv_epi8(points, after, battle);
+        held = _mm256_sub_epi32(held, victory);
+        beaten = _mm256_or_si256(beaten, _mm256_and_si256(battle, enemy_bit));
+
+        //Finished games
+        __m256i lost = _mm256_andnot_si256(won, _mm256_and_si256(playing,
+                       _mm256_or_si256(_mm256_cmpeq_epi32(points, zero), _mm256_cmpgt_epi32(made, limit))));
+        state = _mm256_blendv_epi8(state, won_status, won);
+        state = _mm256_blendv_epi8(state, lost_status, lost);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&status[first]), state);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&position[first]), pos);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&strength[first]), points);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&keys[first]), held);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&fought[first]), beaten);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&moves[first]), made);
+    }
+}
+#else
+void BatchSim::step_avx2(){
+    step_scalar();
+}
+#endif
@@ -0,0 +1,85 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the BatchSim class. A BatchSim plays thousands of independent games
+** in lockstep, one per lane, with every lane choosing random moves and wagers as RandomPolicy does. Instead of a
+** Board and a Player per game, the state of every game is kept as a structure of arrays (position, strength points,
+** keys, enemies fought, moves made and a random number stream per lane), and one step of every game is taken at
+** once by a kernel that works on eight lanes at a time with AVX2, or one at a time where AVX2 isn't available.
+
+** Each lane's board is flattened into two small tables: the cell reached by each move from each cell, with
+** mountains, edges and portals already resolved as in Space::move_player(), and what is on each cell (an enemy and
+** its number, or the vault). A step then follows the rules of Space::move_player(), Teleport::interact(),
+** Enemy::interact() and Finish::interact() with table lookups and arithmetic. The two kernels make the same random
+** draws, so they produce identical games from the same seed.
+
+** Boards of up to 64 cells with at least 13 open cells are supported. The lanes draw from their own generators
+** rather than from one std::default_random_engine, so games aren't the same as play_headless() games with the same
+** seed, only distributed the same.
+******************************************************************************************************************************************************/
+#ifndef BATCHSIM_HPP
+#define BATCHSIM_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Board.hpp"
+
+class BatchSim
+{
+    public:
+        enum Kernel {SCALAR, AVX2};
+
+    private:
+        static const int MAX_CELLS = 64;
+        static const int PIECES = 13;           //Start, vault, two portals and nine enemies, as Board places them
+        static const uint8_t BLOCKED = 255;     //Destination of a move into a mountain or off the board
+        static const uint8_t VAULT = 255;       //Kind of the vault cell. Enemy n has kind n + 1, other cells 0.
+
+        //Lane status
+            static const int PLAYING = 0, LOST = 1, WON = 2, IDLE = 3;
+
+        //A template flattened once: each move's destination ignoring portals, and the open cells
+            struct Layout
+            {
+                int cells;
+                std::vector<uint8_t> moves;         //cells * 8 entries
+                std::vector<uint8_t> open;
+            };
+
+        std::vector<Layout> layouts;
+        std::vector<uint8_t> shuffled;          //Scratch space for placing pieces
+        std::default_random_engine rd;          //Places the pieces of each new board
+        int lanes, starting_strength, max_moves;
+        Kernel kernel;
+
+        //Per-lane boards: lane * MAX_CELLS * 8 + cell * 8 + direction, and lane * MAX_CELLS + cell.
+        //Both have a few bytes of padding so the last lane can be read with 4-byte gathers.
+            std::vector<uint8_t> destination, kind;
+
+        //Per-lane game state
+            std::vector<int32_t> position, strength, keys, fought, moves, status, map_id;
+            std::vector<uint32_t> dice;             //xorshift32 state
+
+        std::vector<long> games, wins;              //Finished games by map id
+
+        void setup_lane(int lane);
+        void step_scalar();
+        void step_avx2();
+
+    public:
+        //Throws a string if a template isn't supported (see above). "lanes" is rounded up to a multiple of 8.
+            BatchSim(const std::vector<MapTemplate>& maps, int lanes, unsigned seed, int starting_strength = 30,
+                     int max_moves = 1000, Kernel kernel = AVX2);
+
+        static bool avx2_available();
+        Kernel getKernel(){return kernel;};         //SCALAR if AVX2 was asked for but isn't available
+
+        //Plays "count" games, starting a new board on each lane as its game finishes.
+            void run(long count);
+
+        const std::vector<long>& getGames(){return games;};
+        const std::vector<long>& getWins(){return wins;};
+};
+
+#endif
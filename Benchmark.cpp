@@ -0,0 +1,146 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the BenchState and BenchmarkRunner classes.
+******************************************************************************************************************************************************/
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <thread>
+
+const long MAX_ITERATIONS = 1000000000;
+
+/*****************************************************************************************************************************************************
+** BenchState(long iterations)
+******************************************************************************************************************************************************/
+BenchState::BenchState(long iterations){
+    this->iterations = remaining = iterations;
+    items = 0;
+    started = false;
+    paused = true;
+    real_seconds = cpu_seconds = 0.0;
+    cpu_start = 0;
+}
+
+void BenchState::pause_timing(){
+    stop_timer();
+}
+
+void BenchState::resume_timing(){
+    paused = false;
+    cpu_start = std::clock();
+    real_start = Clock::now();
+}
+
+/*****************************************************************************************************************************************************
+** stop_timer()
+** Adds the time since the timer was last started. Does nothing if it is already stopped.
+******************************************************************************************************************************************************/
+void BenchState::stop_timer(){
+    if (paused){
+        return;
+    }
+    Clock::time_point real_end = Clock::now();
+    std::clock_t cpu_end = std::clock();
+    paused = true;
+
+    real_seconds += std::chrono::duration<double>(real_end - real_start).count();
+    cpu_seconds += double(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+}
+
+/*****************************************************************************************************************************************************
+** add(const std::string& name, std::function<void(BenchState&)> function)
+******************************************************************************************************************************************************/
+void BenchmarkRunner::add(const std::string& name, std::function<void(BenchState&)> function){
+    benchmarks.push_back(Entry{name, function});
+}
+
+/*****************************************************************************************************************************************************
+** run(const std::string& filter, double min_seconds, std::ostream& out)
+** Each benchmark starts at one iteration. While a run is shorter than "min_seconds", the next run gets enough
+** iterations to reach it, as estimated from the last one, but never more than ten times as many.
+******************************************************************************************************************************************************/
+void BenchmarkRunner::run(const std::string& filter, double min_seconds, std::ostream& out){
+    results.clear();
+
+    out << std::left << std::setw(28) << "Benchmark" << std::right << std::setw(14) << "Time (ns)"
+    << std::setw(14) << "CPU (ns)" << std::setw(14) << "Iterations" << std::setw(16) << "Items/s" << "\n"
+    << std::string(86, '-') << "\n";
+
+    for (Entry& entry : benchmarks){
+        if (entry.name.find(filter) == std::string::npos){
+            continue;
+        }
+
+        long iterations = 1;
+        while (true){
+            BenchState state(iterations);
+            entry.function(state);
+
+            double seconds = state.getRealSeconds();
+            if (seconds >= min_seconds || iterations >= MAX_ITERATIONS){
+                BenchResult result;
+                result.name = entry.name;
+                result.iterations = iterations;
+                result.real_ns = 1e9 * seconds / iterations;
+                result.cpu_ns = 1e9 * state.getCpuSeconds() / iterations;
+                result.items_per_second = (state.getItems() && seconds > 0.0) ? state.getItems() / seconds : 0.0;
+                results.push_back(result);
+                break;
+            }
+
+            double estimate = (seconds > 0.0) ? 1.4 * min_seconds / seconds * iterations : 10.0 * iterations;
+            iterations = std::min<long>(MAX_ITERATIONS, std::max<long>(iterations + 1,
+                                        std::min<double>(estimate, 10.0 * iterations)));
+        }
+
+        const BenchResult& result = results.back();
+        out << std::left << std::setw(28) << result.name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(14) << result.real_ns << std::setw(14) << result.cpu_ns << std::setw(14) << result.iterations
+        << std::setw(16) << std::setprecision(0);
+        if (result.items_per_second > 0.0){
+            out << result.items_per_second;
+        }
+        else {
+            out << "-";
+        }
+        out << std::endl;
+    }
+}
+
+/*****************************************************************************************************************************************************
+** write_json(std::ostream& out, const std::string& executable)
+** Benchmark names and the executable path are written as they are; neither contains quotes or backslashes.
+******************************************************************************************************************************************************/
+void BenchmarkRunner::write_json(std::ostream& out, const std::string& executable){
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    out << "{\n"
+    << "  \"context\": {\n"
+    << "    \"date\": \"" << date << "\",\n"
+    << "    \"executable\": \"" << executable << "\",\n"
+    << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+    << "    \"library_build_type\": \"release\"\n"
+    << "  },\n"
+    << "  \"benchmarks\": [";
+
+    out << std::setprecision(3) << std::fixed;
+    for (size_t index = 0; index < results.size(); index++){
+        const BenchResult& result = results[index];
+        out << (index ? ",\n" : "\n")
+        << "    {\n"
+        << "      \"name\": \"" << result.name << "\",\n"
+        << "      \"iterations\": " << result.iterations << ",\n"
+        << "      \"real_time\": " << result.real_ns << ",\n"
+        << "      \"cpu_time\": " << result.cpu_ns << ",\n"
+        << "      \"time_unit\": \"ns\"";
+        if (result.items_per_second > 0.0){
+            out << ",\n      \"items_per_second\": " << result.items_per_second;
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
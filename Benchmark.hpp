@@ -0,0 +1,96 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for a small microbenchmark harness, modelled on Google Benchmark so the
+** results can be read by the same tools. Each benchmark is a function that loops on BenchState::keep_running()
+** around the code being timed. The harness keeps doubling the number of iterations until one run takes at least
+** the minimum time, then reports the time per iteration of that run.
+
+** Results are printed as a table and written as JSON in Google Benchmark's layout:
+    {"context": {"date", "executable", "num_cpus", "library_build_type"},
+     "benchmarks": [{"name", "iterations", "real_time", "cpu_time", "time_unit", "items_per_second"}]}
+** Times are nanoseconds per iteration. "items_per_second" is only written by benchmarks that count items.
+******************************************************************************************************************************************************/
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class BenchState
+{
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        long iterations, remaining, items;
+        bool started, paused;
+
+        Clock::time_point real_start;
+        std::clock_t cpu_start;
+        double real_seconds, cpu_seconds;       //Time counted so far, not including paused time
+
+        void stop_timer();
+
+    public:
+        explicit BenchState(long iterations);
+
+        //Starts the timer on the first call and stops it once every iteration has run.
+            bool keep_running(){
+                if (remaining-- > 0){
+                    if (!started){
+                        started = true;
+                        resume_timing();
+                    }
+                    return true;
+                }
+                stop_timer();
+                return false;
+            };
+
+        //Leave setup done inside the loop out of the measurement. Each pair costs two clock reads.
+            void pause_timing();
+            void resume_timing();
+
+        void set_items_processed(long items){this->items = items;};
+
+        long   getIterations(){return iterations;};
+        long   getItems(){return items;};
+        double getRealSeconds(){return real_seconds;};
+        double getCpuSeconds(){return cpu_seconds;};
+};
+
+struct BenchResult
+{
+    std::string name;
+    long iterations;
+    double real_ns, cpu_ns;             //Per iteration
+    double items_per_second;            //0 if the benchmark doesn't count items
+};
+
+class BenchmarkRunner
+{
+    private:
+        struct Entry
+        {
+            std::string name;
+            std::function<void(BenchState&)> function;
+        };
+
+        std::vector<Entry> benchmarks;
+        std::vector<BenchResult> results;
+
+    public:
+        void add(const std::string& name, std::function<void(BenchState&)> function);
+
+        //Runs every benchmark whose name contains "filter", printing a line for each as it finishes.
+            void run(const std::string& filter, double min_seconds, std::ostream& out);
+
+        //Writes the results of the last run() as JSON
+            void write_json(std::ostream& out, const std::string& executable);
+};
+
+#endif
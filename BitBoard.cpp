@@ -0,0 +1,113 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the BitBoard class.
+******************************************************************************************************************************************************/
+#include "BitBoard.hpp"
+
+/*****************************************************************************************************************************************************
+** BitBoard(const string& layout, int rows, int cols)
+** Builds the masks from a filled template, the string passed to Board::populate_board(). 'A' is a mountain,
+** 'e' an enemy, 'O' a portal, '!' the vault and 'x' the player's starting position.
+******************************************************************************************************************************************************/
+BitBoard::BitBoard(const string& layout, int rows, int cols){
+    this->rows = rows;
+    this->cols = cols;
+
+    int cells = rows * cols;
+    all = (cells == 64) ? ~Mask(0) : (bit(cells) - 1);
+
+    Mask left_col = 0, right_col = 0;
+    for (int row = 0; row < rows; row++){
+        left_col  |= bit(row * cols);
+        right_col |= bit(row * cols + cols - 1);
+    }
+    not_left = all & ~left_col;
+    not_right = all & ~right_col;
+
+    //Bit offset of each direction, from the direction table in Grid.hpp
+    Grid grid(rows, cols);
+    for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+        int offset = grid.offset(dir), col_step = DIRECTIONS[dir].col;
+        shift_up[dir]   = (offset > 0) ?  offset : 0;
+        shift_down[dir] = (offset < 0) ? -offset : 0;
+        pre_mask[dir]   = (col_step < 0) ? not_left : (col_step > 0) ? not_right : all;
+    }
+
+    mountains = enemies = teleports = vault = visited = position = 0;
+    for (int index = 0; index < cells && index < (int)layout.length(); index++){
+        switch(layout[index]){
+            case('A'):  mountains |= bit(index);
+                        break;
+            case('e'):  enemies |= bit(index);
+                        break;
+            case('O'):  teleports |= bit(index);
+                        break;
+            case('!'):  vault |= bit(index);
+                        break;
+            case('x'):  position = bit(index);
+                        break;
+        }
+    }
+    visited = position;
+}
+
+/*****************************************************************************************************************************************************
+** Mask neighbours(Mask m)
+******************************************************************************************************************************************************/
+BitBoard::Mask BitBoard::neighbours(Mask m) const {
+    Mask result = 0;
+    for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+        result |= shift(m, dir);
+    }
+    return result;
+}
+
+/*****************************************************************************************************************************************************
+** Mask flood_fill(Mask seed, Mask open)
+** Grows "seed" one ring of neighbours at a time until it stops changing.
+******************************************************************************************************************************************************/
+BitBoard::Mask BitBoard::flood_fill(Mask seed, Mask open) const {
+    Mask filled = seed & open, previous = 0;
+    while (filled != previous){
+        previous = filled;
+        filled |= neighbours(filled) & open;
+    }
+    return filled;
+}
+
+/*****************************************************************************************************************************************************
+** Mask destination(Mask from, int dir)
+** Branch-free version of the rules in Space::move_player().
+******************************************************************************************************************************************************/
+BitBoard::Mask BitBoard::destination(Mask from, int dir) const {
+    Mask next = shift(from, dir) & ~mountains;
+
+    //All ones if the move lands on a portal, in which case the player comes out of the other one
+    Mask portal = -Mask((next & teleports) != 0);
+    next = (next & ~portal) | (teleports & ~next & portal);
+
+    //All ones if the move is blocked, in which case the player stays put
+    Mask blocked = -Mask(next == 0);
+    return next | (from & blocked);
+}
+
+/*****************************************************************************************************************************************************
+** Mask move(int dir)
+******************************************************************************************************************************************************/
+BitBoard::Mask BitBoard::move(int dir){
+    position = destination(position, dir);
+    visited |= position;
+    return position;
+}
+
+/*****************************************************************************************************************************************************
+** Mask legal_moves()
+******************************************************************************************************************************************************/
+BitBoard::Mask BitBoard::legal_moves() const {
+    Mask result = 0;
+    for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+        result |= destination(position, dir);
+    }
+    return result & ~position;
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the BitBoard class, a compact alternative to the Space* graph
+** built by Board. Each kind of space is stored as a 64-bit mask with one bit per cell, so moving the player
+** is a shift-and-mask operation instead of following a pointer and making a virtual interact() call.
+** Boards of up to 64 cells are supported.
+
+** Cells are numbered row * COLS + col, using the same rows and columns as Board: row 0 is the first row of
+** the template and "top" is row + 1.
+******************************************************************************************************************************************************/
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "Grid.hpp"
+
+using std::string;
+
+class BitBoard
+{
+    public:
+        typedef uint64_t Mask;
+
+        static const int NUM_DIRECTIONS = ::NUM_DIRECTIONS;
+
+    private:
+        int rows, cols;
+
+        //Masks describing the board itself. "not_left" and "not_right" exclude the first and last column
+        //so that a sideways shift can't wrap around onto the neighbouring row.
+            Mask all, not_left, not_right;
+
+        //Per-direction shift amounts, indexed in the order of the default controls "12346789".
+        //Exactly one of the two shifts is non-zero for each direction.
+            int  shift_up[NUM_DIRECTIONS], shift_down[NUM_DIRECTIONS];
+            Mask pre_mask[NUM_DIRECTIONS];
+
+        //Board contents
+            Mask mountains, enemies, teleports, vault;
+
+        //Game state
+            Mask visited;           //Every cell the player has occupied
+            Mask position;          //Exactly one bit set: the player's current cell
+
+    public:
+        BitBoard(const string& layout, int rows = 6, int cols = 6);     //"layout" is a filled template, see Board::getLayout()
+
+        static Mask bit(int cell){return Mask(1) << cell;};
+        static int  cell(Mask m){return __builtin_ctzll(m);};           //Index of the lowest set bit
+        static int  count(Mask m){return __builtin_popcountll(m);};
+
+        static int  direction(char move){return move_direction(move);};        //'1'-'4','6'-'9' -> 0-7
+
+        //Moves every set bit in "m" one step in direction "dir". Bits that would leave the board are dropped.
+            Mask shift(Mask m, int dir) const {
+                return (((m & pre_mask[dir]) << shift_up[dir]) >> shift_down[dir]) & all;
+            };
+
+        Mask neighbours(Mask m) const;                  //Every cell adjacent to any cell in "m"
+        Mask flood_fill(Mask seed, Mask open) const;    //Every cell of "open" reachable from "seed" through "open"
+
+        //Cell the player would end up in after moving in direction "dir" from "from": the same cell when the
+        //move is off the edge or into a mountain, the other portal when it lands on a portal.
+            Mask destination(Mask from, int dir) const;
+
+        //Mirrors Space::move_player(): updates the position and visited set, returns the new position.
+            Mask move(int dir);
+
+        //Cells the player can reach in one move from the current position, portals already resolved.
+            Mask legal_moves() const;
+
+        //Getter methods
+            int  getRows()      const {return rows;};
+            int  getCols()      const {return cols;};
+            Mask getCells()     const {return all;};
+            Mask getMountains() const {return mountains;};
+            Mask getEnemies()   const {return enemies;};
+            Mask getTeleports() const {return teleports;};
+            Mask getVault()     const {return vault;};
+            Mask getVisited()   const {return visited;};
+            Mask getPosition()  const {return position;};
+
+        void clear_enemy(Mask cell){enemies &= ~cell;};   //Called once the enemy on "cell" has been fought
+};
+
+#endif
@@ -5,6 +5,12 @@
 ** 2D vector of pointers to Space objects which can be used to play a game of Treasure Quest.
 ******************************************************************************************************************************************************/
 #include "Board.hpp"
+#include "MapPack.hpp"
+#include "Metrics.hpp"
+#include "DistanceCache.hpp"
+
+#include <cstdio>
+#include <new>
 
 /*****************************************************************************************************************************************************
 ** Board()
@@ -12,35 +18,230 @@
 ** objects derived from the Space class. Passes the template to the function that creates the board.
 ******************************************************************************************************************************************************/
 Board::Board(){
-    //Initialize and seed a random number engine to be used to permute a string
+    cells_built = false;
+    distances_current = false;
+    distance_rows = 0;
+    lazy = false;
+
+    //Initialize and seed a random number engine to be used to choose and fill a template
     std::default_random_engine rd;
     std::random_device seed_gen{};
     rd.seed(seed_gen());
-    
+
+    build_from_file(rd);
+}
+
+/*****************************************************************************************************************************************************
+** Board(std::default_random_engine& rd)
+** Board constructor for reproducible games. The same engine state always produces the same board.
+******************************************************************************************************************************************************/
+Board::Board(std::default_random_engine& rd){
+    cells_built = false;
+    distances_current = false;
+    distance_rows = 0;
+    lazy = false;
+    build_from_file(rd);
+}
+
+/*****************************************************************************************************************************************************
+** build_from_file(std::default_random_engine& rd)
+** Called by the constructors that read their template from the map file.
+******************************************************************************************************************************************************/
+void Board::build_from_file(std::default_random_engine& rd){
     //Attempt to select a map from "maps.txt" An exception will be thrown if the size of the map
-    //does not match the size of the board (map length == ROWS * COLS)
-    string map;
+    //does not match its dimensions (map length == rows * cols)
+    MapTemplate map;
     try{
-        map = choose_map();
+        map = choose_map(rd);
     }
     catch (string size_error){
         cout << size_error;
     }
 
+    build(map, rd);
+}
+
+/*****************************************************************************************************************************************************
+** Board(const std::vector<MapTemplate>& maps, std::default_random_engine& rd)
+** Board constructor used by the simulators. Chooses one of the templates returned by load_maps() using the
+** caller's random number engine, so no file is read and no engine is seeded per game.
+******************************************************************************************************************************************************/
+Board::Board(const std::vector<MapTemplate>& maps, std::default_random_engine& rd){
+    cells_built = false;
+    distances_current = false;
+    distance_rows = 0;
+    lazy = false;
+    map_id = std::uniform_int_distribution<int>{0, (int)maps.size() - 1}(rd);
+    build(maps[map_id], rd);
+}
+
+/*****************************************************************************************************************************************************
+** Board(const MapPack& pack, std::default_random_engine& rd)
+** Board constructor used by the simulators with packs too large to load into a vector.
+******************************************************************************************************************************************************/
+Board::Board(const MapPack& pack, std::default_random_engine& rd){
+    cells_built = false;
+    distances_current = false;
+    distance_rows = 0;
+    lazy = false;
+    map_id = std::uniform_int_distribution<uint64_t>{0, pack.size() - 1}(rd);
+    build(pack.get(map_id), rd);
+}
+
+/*****************************************************************************************************************************************************
+** build(const MapTemplate& map, std::default_random_engine& rd)
+** Called by the constructors and reset() once a template has been chosen.
+******************************************************************************************************************************************************/
+void Board::build(const MapTemplate& map, std::default_random_engine& rd){
+    Metrics::Timer timer(Metrics::BOARD_BUILD);
+
+    rows = map.rows;
+    cols = map.cols;
+    base_template = map.cells;
+
+    reshuffle(rd);
+}
+
+/*****************************************************************************************************************************************************
+** reshuffle(std::default_random_engine& rd)
+** Places the pieces on the current template again and rebuilds every Space in its existing slot. The strings and
+** vectors involved keep their memory between games, so nothing is allocated.
+******************************************************************************************************************************************************/
+void Board::reshuffle(std::default_random_engine& rd){
+    layout = base_template;
+    fill_template(layout, to_permute, rd);  //Randomly place the player, vault, portals and enemies on the template
+    populate_board(layout);                 //Use the filled template as a blueprint for the game board.
+}
+
+/*****************************************************************************************************************************************************
+** reset(const std::vector<MapTemplate>& maps, std::default_random_engine& rd)
+** Same as constructing a new Board from "maps", but reuses this board's memory. Only allocates if the chosen
+** template is larger than any this board has held before.
+******************************************************************************************************************************************************/
+void Board::reset(const std::vector<MapTemplate>& maps, std::default_random_engine& rd){
+    map_id = std::uniform_int_distribution<int>{0, (int)maps.size() - 1}(rd);
+    build(maps[map_id], rd);
+}
+
+/*****************************************************************************************************************************************************
+** load_layout(const string& layout)
+** Rebuilds every Space in its existing slot from "layout" without placing the pieces again.
+******************************************************************************************************************************************************/
+void Board::load_layout(const string& layout){
+    if ((int)layout.length() != rows * cols){
+        throw string("ERROR: Layout length does not match the board's dimensions\n");
+    }
+    this->layout = layout;
+    populate_board(this->layout);
+}
+
+/*****************************************************************************************************************************************************
+** load_layout(const string& layout, int rows, int cols, int map_id)
+** The template is the layout with the pieces taken off, so reshuffle() works on the restored board as usual.
+******************************************************************************************************************************************************/
+void Board::load_layout(const string& layout, int rows, int cols, int map_id){
+    if (rows <= 0 || cols <= 0 || (int)layout.length() != rows * cols){
+        throw string("ERROR: Layout length does not match the board's dimensions\n");
+    }
+    destroy_cells();                        //The old cells are indexed by the old dimensions
+    this->rows = rows;
+    this->cols = cols;
+    this->map_id = map_id;
+
+    base_template = layout;
+    for (char& cell : base_template){
+        cell = (cell == 'A') ? 'A' : '.';
+    }
+    load_layout(layout);
+}
+
+/*****************************************************************************************************************************************************
+** Space* findCell(int cell)
+******************************************************************************************************************************************************/
+Space* Board::findCell(int cell){
+    if (!lazy){
+        return board[cell / cols][cell % cols];
+    }
+    std::unordered_map<int, Space*>::iterator found = lazy_cells.find(cell);
+    return (found != lazy_cells.end() && found->second->getType() != UNBUILT) ? found->second : nullptr;
+}
+
+/*****************************************************************************************************************************************************
+** int getIndex(Space* space)
+** On an eagerly built board a Space's index is its slot in the arena. A lazily built board looks the Space up in
+** lazy_indices. A cell keeps its slot when it is materialized, so the entry made for its Frontier still holds.
+******************************************************************************************************************************************************/
+int Board::getIndex(Space* space){
+    if (!lazy){
+        CellSlot* slot = reinterpret_cast<CellSlot*>(space);
+        return (slot >= arena.data() && slot < arena.data() + rows * cols) ? int(slot - arena.data()) : -1;
+    }
+    std::unordered_map<Space*, int>::iterator found = lazy_indices.find(space);
+    return (found != lazy_indices.end()) ? found->second : -1;
+}
+
+/*****************************************************************************************************************************************************
+** const BoardDistances* getDistances()
+** A board built from the same template as the last one reuses its matrix, so after the first game only the
+** board's portals are worked out again.
+******************************************************************************************************************************************************/
+const BoardDistances* Board::getDistances(){
+    if (lazy){
+        return nullptr;
+    }
+    if (distances_current){
+        return distances.get();
+    }
+
+    if (!distances){
+        distance_cache.reset(new DistanceCache());
+        distances.reset(new BoardDistances());
+    }
+    if (distance_rows != rows || distance_template != base_template){
+        distances->assign(distance_cache->get(MapTemplate{rows, cols, base_template}), layout);
+        distance_template = base_template;
+        distance_rows = rows;
+    }
+    else {
+        distances->assign(distances->getMatrix(), layout);
+    }
+    distances_current = true;
+    return distances.get();
+}
+
+/*****************************************************************************************************************************************************
+** string place_pieces(string map, std::default_random_engine& rd)
+** Takes a template from "maps.txt" and returns a copy with the pieces placed by fill_template().
+******************************************************************************************************************************************************/
+string Board::place_pieces(string map, std::default_random_engine& rd){
+    string to_permute;
+    fill_template(map, to_permute, rd);
+    return map;
+}
+
+/*****************************************************************************************************************************************************
+** fill_template(string& map, string& to_permute, std::default_random_engine& rd)
+** Randomly replaces some of the '.' characters in "map" with the player's start ('x'), the vault ('!'), the
+** portals ('O') and the enemies ('e'). "to_permute" is scratch space.
+
+** A 6x6 board gets 1 vault, 2 portals and 9 enemies. Larger boards get that many for every 36 cells.
+******************************************************************************************************************************************************/
+void Board::fill_template(string& map, string& to_permute, std::default_random_engine& rd){
     //String "map" will contain the characters 'A' and '.'
     //At random, some of the '.' characters will be replaced with 'x', '!', 'e', or 'O'.
 
-    int spaces = std::count(map.begin(), map.end(), '.');
+    size_t spaces = std::count(map.begin(), map.end(), '.');
+    int scale = std::max(1, (int)map.length() / 36);
 
-    string to_permute = "x!OO";
-    for (int index = 0; index < 9; index++){
-        to_permute += 'e';
-    }
-    while (to_permute.length() < spaces){
-        to_permute += '.';
+    to_permute.assign(1, 'x');
+    to_permute.append(scale, '!');
+    to_permute.append(2 * scale, 'O');
+    to_permute.append(9 * scale, 'e');
+    if (to_permute.length() < spaces){
+        to_permute.append(spaces - to_permute.length(), '.');
     }
 
-    //At this point, to_permute will equal "x!00eeeeeeeeee", followed by
+    //At this point, on a 6x6 board to_permute will equal "x!OOeeeeeeeee", followed by
     //enough '.' characters so that its length is equal to "spaces".
     
     //Randomly permute "to_permute"
@@ -48,26 +249,86 @@ Board::Board(){
     
     int to_permute_index = 0;                               //Will act as a pointer to a character in "to_permute"
 
-    for (int index = 0; index < map.length(); index++){     //Iterate over each character in "map"
+    for (size_t index = 0; index < map.length(); index++){  //Iterate over each character in "map"
     
         if (map[index] == '.'){                             //If the character is equal to '.' ...
             map[index] = to_permute[to_permute_index];      //...set it equal to the "to_permute" character being pointed at...
             to_permute_index++;                             //...and update the pointer
         }
     }
-    
-    populate_board(map);        //Use "map" as a blueprint for the game board.
 }
 
 /*****************************************************************************************************************************************************
-** string choose_map()
-** Opens a text file containing game board templates and randomly choses one.
+** MapTemplate parse_map(const string& line)
+** Reads one line of a map file. A line is either a 36 character 6x6 template, or the board's dimensions written
+** as "<rows>x<cols>" followed by a space and the template, e.g. "8x8 ....A...". Throws a string if the template's
+** length doesn't match its dimensions, or it has too few open cells for every piece (see min_open()).
 ******************************************************************************************************************************************************/
-string Board::choose_map(){
-    //Initialize and seed a random number engine
-    std::default_random_engine rd;
-    std::random_device seed_gen{};
-    rd.seed(seed_gen());
+MapTemplate Board::parse_map(const string& line){
+    MapTemplate map;
+    map.rows = map.cols = 6;
+    map.cells = line;
+
+    size_t space = line.find(' ');
+    if (space != string::npos){
+        if (std::sscanf(line.c_str(), "%dx%d", &map.rows, &map.cols) != 2){
+            throw string("ERROR: Map dimensions must be written as <rows>x<cols>\n");
+        }
+        map.cells = line.substr(space + 1);
+    }
+
+    if (map.rows <= 0 || map.cols <= 0 || map.cells.length() != (size_t)map.rows * map.cols){
+        throw string("ERROR: Map string length and number of board spaces must be the same size\n");
+    }
+    if (std::count(map.cells.begin(), map.cells.end(), '.') < min_open(map.cells.length())){
+        throw string("ERROR: Map has too few open spaces for every piece\n");
+    }
+    return map;
+}
+
+/*****************************************************************************************************************************************************
+** std::vector<MapTemplate> load_maps(const string& filename)
+** Reads every template from a map file in the format written by mapmaker.hpp: the number of templates on the
+** first line, followed by one template per line.
+******************************************************************************************************************************************************/
+std::vector<MapTemplate> Board::load_maps(const string& filename){
+    std::fstream map_file_stream;
+    map_file_stream.open(filename);
+
+    int num_maps = 0;
+    map_file_stream >> num_maps;
+    map_file_stream.ignore();
+
+    std::vector<MapTemplate> maps;
+    string map;
+    for (int index = 0; index < num_maps && getline(map_file_stream, map); index++){
+        maps.push_back(parse_map(map));
+    }
+    return maps;
+}
+
+/*****************************************************************************************************************************************************
+** MapPack& default_pack()
+** The map pack used by choose_map(). Opened once, the first time a board is built, and shared by every board after that.
+******************************************************************************************************************************************************/
+static MapPack& default_pack(){
+    static MapPack pack("maps.pack");
+    return pack;
+}
+
+/*****************************************************************************************************************************************************
+** MapTemplate choose_map(std::default_random_engine& rd)
+** Randomly chooses a game board template. If "maps.pack" exists (see MapPack.hpp), the template is looked up
+** in it directly. Otherwise, opens the text file "maps.txt" and reads down to the chosen line.
+******************************************************************************************************************************************************/
+MapTemplate Board::choose_map(std::default_random_engine& rd){
+    Metrics::Timer timer(Metrics::MAP_READ);
+
+    MapPack& pack = default_pack();
+    if (pack.size() > 0){
+        map_id = std::uniform_int_distribution<uint64_t>{0, pack.size() - 1}(rd);
+        return pack.get(map_id);
+    }
 
     std::fstream map_file_stream;
     string map;
@@ -76,146 +337,244 @@ string Board::choose_map(){
     int num_maps;                       
     map_file_stream >> num_maps;        //First line of "maps.txt" should contain the number of templates.
     int choose_map = std::uniform_int_distribution<int>{1, num_maps}(rd);
+    map_id = choose_map - 1;
 
     map_file_stream.ignore();
     for(int index=0; index < choose_map; index++){
         getline(map_file_stream, map);
     }
-    
-    if (map.length() != (ROWS * COLS)){
-        throw string("ERROR: Map string length and number of board spaces must be the same size\n");
-    }
 
-    return map;
+    return parse_map(map);
+}
+
+/*****************************************************************************************************************************************************
+** link_cells(const GridType& grid)
+** Sets the eight neighbour pointers that each Space-derived object has as data members. With "r" and "c" the row
+** and column of a space, its neighbour in direction "dir" is *board[r + DIRECTIONS[dir].row][c + DIRECTIONS[dir].col],
+** or nullptr on the edge of the board.
+******************************************************************************************************************************************************/
+struct Board::CellLinker
+{
+    Board* owner;
+
+    template <class GridType>
+    void operator()(const GridType& grid) const {owner->link_cells(grid);}
+};
+
+template <class GridType>
+void Board::link_cells(const GridType& grid){
+    //Returns the space at (row, col), or nullptr if that is off the board
+    auto at = [this, &grid](int row, int col) -> Space* {
+        return (row < 0 || row >= grid.rows() || col < 0 || col >= grid.cols()) ? nullptr : board[row][col];
+    };
+
+    for (int row = 0; row < grid.rows(); row++){
+        for (int col = 0; col < grid.cols(); col++){
+            Space* space = board[row][col];
+
+            for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+                space->setNeighbour(dir, at(row + DIRECTIONS[dir].row, col + DIRECTIONS[dir].col));
+            }
+        }
+    }
 }
 
 /*****************************************************************************************************************************************************
 ** populate_board(string board_template)
 ** Builds a game board based on a passed template. The template will be a string containing:
 ** - 1 'x' character
-** - 1 '!' character
-** - 2 'O' characters
-** - 10 'e' characters
-** - Enough 'A' and '.' characters so that the length of board_template equals (ROWS * COLS)
+** - '!', 'O' and 'e' characters, as placed by place_pieces()
+** - Enough 'A' and '.' characters so that the length of board_template equals (rows * cols)
 
 ** This function modifies the "board" private data member (A 2D Space* vector) by populating it
-** with pointers to various objects derived from Space, with the type of derived object being 
-** determined by the template.
+** with pointers to various objects derived from Space, with the type of derived object being
+** determined by the template. Any Space objects already on the board are destroyed first.
+** Boards with more than LAZY_CELLS cells are handed to populate_lazy() instead.
 ******************************************************************************************************************************************************/
-void Board::populate_board(string board_template){
-    bool first_tp_found = false;
-    Space *tp1, *tp2;
+void Board::populate_board(const string& board_template){
+    destroy_cells();
+    distances_current = false;
 
-    //Iterate over the template. Use the character to decide what type of pointer will be placed
-    //in "board" at the location pointed to by "row" and "col".
-    int row=-1, col= COLS - 1, number = 0;
-    for (char icon : board_template){
+    if (board_template.length() > (size_t)LAZY_CELLS){
+        populate_lazy(board_template);
+        return;
+    }
+    lazy = false;
+
+    if (arena.size() < board_template.length()){
+        arena.resize(board_template.length());
+    }
+    if ((int)board.size() != rows || board[0].size() != (size_t)cols){
+        board.assign(rows, std::vector<Space*>(cols));
+    }
+    teleports.clear();
+
+    //Iterate over the template. Use the character to decide what type of Space will be constructed
+    //in the next arena slot and placed in "board" at the location pointed to by "row" and "col".
+    int row = 0, col = 0;
+    for (size_t index = 0; index < board_template.length(); index++){
+        board[row][col] = construct_cell(board_template[index], &arena[index]);
+
+        if (board_template[index] == 'x'){
+            player_start[0] = row;
+            player_start[1] = col;
+        }
+        else if (board_template[index] == 'O'){         //Each Teleport space must know where its partner is in order
+            teleports.push_back(board[row][col]);       //for them to work as intended.
+        }
 
         col++;
-        if (col == COLS){
+        if (col == cols){
             col = 0;
             row++;
-            std::vector<Space*> new_row(COLS);
-            board.push_back(new_row);
         }
+    }
+    cells_built = true;
+    start = board[player_start[0]][player_start[1]];
+
+    //Link the Teleport spaces to each other in pairs, in the order they appear in the template.
+    for (size_t index = 0; index + 1 < teleports.size(); index += 2){
+        teleports[index]->set_other_teleport(teleports[index + 1]);
+        teleports[index + 1]->set_other_teleport(teleports[index]);
+    }
 
-        switch(icon){
-            case('A'):  {board[row][col] = new Mountain('A');
-                        number++;
-                        break;}
-            
-            case('.'):  {board[row][col] = new Blank('.');
-                        number++;
-                        break;}
-
-            case('e'):  {board[row][col] = new Enemy('.');  //Enemies are hidden on the board, so both Enemy and Blank cells will appear identical
-                        number++;
-                        break;}
-            
-            case('x'):  {board[row][col] = new Blank('x');
-                        number++;
-                        player_start[0] = row;
-                        player_start[1] = col;
-                        break;}
-            
-            case('!'):  {board[row][col] = new Finish('!');
-                        number++;
-                        break;}
-            
-            case('O'):  {board[row][col] = new Teleport('O');
-                        number++;
-                        if (!first_tp_found){           //Each Teleport space must know where the other one is in order
-                            tp1 = board[row][col];      //for them to work as intended.
-                            first_tp_found = true;
-                            break;
-                        }
-                        tp2 = board[row][col];
-                        break;}
+    with_grid(rows, cols, CellLinker{this});
+}
+
+/*****************************************************************************************************************************************************
+** populate_lazy(const string& board_template)
+** Builds only the player's starting cell and a Frontier for each of its neighbours. Every other cell is built by
+** materialize() when the player's moves reach it. The portals are listed so a portal can find its partner.
+******************************************************************************************************************************************************/
+void Board::populate_lazy(const string& board_template){
+    lazy = true;
+    lazy_arena.clear();
+    lazy_cells.clear();
+    lazy_indices.clear();
+    portal_cells.clear();
+
+    for (size_t index = 0; index < board_template.length(); index++){
+        if (board_template[index] == 'O'){
+            portal_cells.push_back(index);
         }
     }
 
-    //Link the two teleport spaces to each other.
-    tp1->set_other_teleport(tp2);
-    tp2->set_other_teleport(tp1);
+    int cell = board_template.find('x');
+    player_start[0] = cell / cols;
+    player_start[1] = cell % cols;
 
-    /*
-    The following for-loops set the eight Space* pointers that each Space-derived object
-    has as data members. The pointers for *board[r][c] would point to the following objects:
+    cells_built = true;
+    start = materialize(cell);
+}
 
-    top -          *board[r+1][c]
-    bottom -       *board[r-1][c]
-    left -         *board[r][c-1]
-    right -        *board[r][c+1]
-    top_left -     *board[r+1][c-1]
-    top_right -    *board[r+1][c+1]
-    bottom_left -  *board[r-1][c-1]
-    bottom_right - *board[r-1][c+1]
-    */
+/*****************************************************************************************************************************************************
+** Space* construct_cell(char piece, void* slot)
+** Constructs the Space for one character of a filled-in template in "slot" and returns it.
+******************************************************************************************************************************************************/
+Space* Board::construct_cell(char piece, void* slot){
+    switch(piece){
+        case('A'):  return new (slot) Mountain('A');
+        case('e'):  return new (slot) Enemy('.');       //Enemies are hidden on the board, so both Enemy and Blank cells will appear identical
+        case('x'):  return new (slot) Blank('x');
+        case('!'):  return new (slot) Finish('!');
+        case('O'):  return new (slot) Teleport('O');
+        default:    return new (slot) Blank('.');
+    }
+}
 
+/*****************************************************************************************************************************************************
+** char hidden_sprite(char piece)
+** The sprite of a cell before the player has been there. Enemies look like any other settlement.
+******************************************************************************************************************************************************/
+char Board::hidden_sprite(char piece){
+    return (piece == 'e' || piece == 'x') ? '.' : piece;
+}
 
-    //Set the "left" and "right" pointers of each space on the Board.
-    for (int row = 0; row < ROWS; row++){
-        for (int col = 0; col < (COLS - 1); col++){
-            Space *space = board[row][col],
-            *next_space = board[row][col + 1];
+/*****************************************************************************************************************************************************
+** Space* lazy_cell(int cell)
+******************************************************************************************************************************************************/
+Space* Board::lazy_cell(int cell){
+    Space*& space = lazy_cells[cell];
+    if (!space){
+        lazy_arena.emplace_back();
+        space = new (&lazy_arena.back()) Frontier(hidden_sprite(layout[cell]), this, cell);
+        lazy_indices[space] = cell;
+    }
+    return space;
+}
 
-            space->setRight(next_space);
-            next_space->setLeft(space);
-        }
+/*****************************************************************************************************************************************************
+** Space* materialize(int cell)
+** Builds the Space at "cell" from the layout, in the slot of the Frontier that stood in for it, so every pointer to
+** the Frontier now points to the new Space. Unless the cell is a mountain, which the player never stands on, it is
+** linked to all of its neighbours, with a new Frontier for each one that hasn't been built. A portal builds its
+** partner as well, since a move onto one lands on the other.
+******************************************************************************************************************************************************/
+Space* Board::materialize(int64_t cell){
+    Space* space = lazy_cell(cell);
+    if (space->getType() != UNBUILT){
+        return space;
     }
+    space->~Space();
+    space = construct_cell(layout[cell], space);
 
-    //Set the "up" and "down" pointers of each space on the Board
-    for (int col = 0; col < COLS; col++){
-        for (int row = 0; row < (ROWS - 1); row++){
-            Space *space = board[row][col],
-            *next_space = board[row + 1][col];
+    if (space->getType() == MOUNTAIN){
+        return space;
+    }
 
-            space->setTop(next_space);
-            next_space->setBottom(space);            
+    Grid grid(rows, cols);
+    for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+        int next = grid.neighbour(cell, dir);
+        Space* neighbour = (next < 0) ? nullptr : lazy_cell(next);
+
+        space->setNeighbour(dir, neighbour);
+        if (neighbour){
+            neighbour->setNeighbour(NUM_DIRECTIONS - 1 - dir, space);      //DIRECTIONS lists opposite directions symmetrically
         }
     }
 
-    //Set the "top_right" and "bottom_left" pointers of each space on the Board
-    for (int row = 0; row < (ROWS - 1); row++){
-        for (int col = 0; col < (COLS - 1); col++){
-            Space *space = board[row][col],
-            *next_space = board[row + 1][col + 1];
-
-            space->setTopRight(next_space);
-            next_space->setBottomLeft(space);            
+    if (space->getType() == TELEPORT){
+        int position = std::find(portal_cells.begin(), portal_cells.end(), cell) - portal_cells.begin();
+        int partner = position ^ 1;                 //Portals are paired in the order they appear in the template
+        if (partner < (int)portal_cells.size()){
+            Space* other = materialize(portal_cells[partner]);
+            space->set_other_teleport(other);
+            other->set_other_teleport(space);
         }
     }
+    return space;
+}
 
-    //Set the "top_left" and "bottom_right" pointers of each space on the Board
-    for (int row = (ROWS - 1); row > 0; row--){
-        for (int col = 0; col < (COLS - 1); col++){
-            Space *space = board[row][col],
-            *next_space = board[row - 1][col + 1];
+/*****************************************************************************************************************************************************
+** char lazy_sprite(int cell)
+** The sprite of a cell on a lazily built board, taken from the layout if nothing has been built there.
+******************************************************************************************************************************************************/
+char Board::lazy_sprite(int cell){
+    std::unordered_map<int, Space*>::iterator found = lazy_cells.find(cell);
+    return (found != lazy_cells.end()) ? found->second->getSprite() : hidden_sprite(layout[cell]);
+}
 
-            space->setBottomRight(next_space);
-            next_space->setTopLeft(space);            
+/*****************************************************************************************************************************************************
+** destroy_cells()
+** Destroys every Space that has been built. The memory of the arena is kept for the next board.
+******************************************************************************************************************************************************/
+void Board::destroy_cells(){
+    if (!cells_built){
+        return;
+    }
+    if (lazy){
+        for (std::pair<const int, Space*>& entry : lazy_cells){
+            entry.second->~Space();
+        }
+    }
+    else {
+        for (size_t row = 0; row < board.size(); row++){
+            for (size_t col = 0; col < board[row].size(); col++){
+                board[row][col]->~Space();
+            }
         }
     }
+    cells_built = false;
 }
 
 /*****************************************************************************************************************************************************
@@ -223,23 +582,40 @@ void Board::populate_board(string board_template){
 ** Displays the board in its current state to the player.
 ******************************************************************************************************************************************************/
 void Board::showBoard(){
-    for (int row = (ROWS - 1); row > -1; row--){
-        for (int col = 0; col < COLS; col++){
-            cout << board[row][col]->getSprite() << " ";
+    showBoard(cout);
+}
+
+/*****************************************************************************************************************************************************
+** showBoard(std::ostream& out)
+******************************************************************************************************************************************************/
+void Board::showBoard(std::ostream& out){
+    for (int row = (rows - 1); row > -1; row--){
+        for (int col = 0; col < cols; col++){
+            out << (lazy ? lazy_sprite(row * cols + col) : board[row][col]->getSprite()) << " ";
         }
-        cout << endl;
+        out << "\n";
     }
-    cout << endl;
+    out << "\n";
 }
 
 /*****************************************************************************************************************************************************
-** ~Board()
-** Frees the memory pointed to by the pointers in "board"
+** getSprites(string& sprites)
+** Overwrites "sprites" with rows * cols characters. Reuses its memory, so a caller can keep one string per frame.
 ******************************************************************************************************************************************************/
-Board::~Board(){
-    for (int row=0; row < ROWS; row++){
-        for (int col=0; col < COLS; col++){
-            delete board[row][col];
+void Board::getSprites(string& sprites){
+    sprites.resize(rows * cols);
+    int index = 0;
+    for (int row = (rows - 1); row > -1; row--){
+        for (int col = 0; col < cols; col++){
+            sprites[index++] = lazy ? lazy_sprite(row * cols + col) : board[row][col]->getSprite();
         }
     }
-}
\ No newline at end of file
+}
+
+/*****************************************************************************************************************************************************
+** ~Board()
+** Destroys the Space objects. The arena holding them is freed along with the rest of the Board.
+******************************************************************************************************************************************************/
+Board::~Board(){
+    destroy_cells();
+}
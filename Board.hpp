@@ -3,35 +3,148 @@
 ** Date: 12/10/19
 ** Description: This is the interface file for the Board class. This class creates a
 ** 2D vector of pointers to Space objects which can be used to play a game of Treasure Quest.
+
+** Boards with more than LAZY_CELLS cells are built lazily. Only the filled-in layout (one character per cell) is
+** kept for the whole board, and a Space is constructed the first time the player could move onto it: when the
+** player arrives at a cell, each of its neighbours that hasn't been built yet gets a Frontier, and a move onto a
+** Frontier replaces it, at the same address, with the cell from the layout. Memory and build time grow with the
+** cells the player has been next to rather than with the area of the board.
 ******************************************************************************************************************************************************/
 #ifndef BOARD_HPP 
 #define BOARD_HPP
 
 #include <fstream>
 #include <algorithm>
+#include <type_traits>
+#include <deque>
+#include <unordered_map>
+#include <memory>
 
 #include "Space.hpp"
+#include "Grid.hpp"
+
+class MapPack;
+class DistanceCache;
+class BoardDistances;
+
+//A board template from a map file: 'A' for mountains and '.' for open cells, row by row.
+struct MapTemplate
+{
+    int rows, cols;
+    string cells;
+};
 
-class Board
+class Board : private CellSource
 {
     private:
-        const int ROWS = 6, COLS = 6;           //Board dimensions
+        int rows, cols;                         //Board dimensions, taken from the template
         std::vector<std::vector<Space*>> board;
 
+        //Every Space on the board is constructed in place in one contiguous block, one slot per cell, so building
+        //or rebuilding a board doesn't allocate once the block is big enough.
+            typedef std::aligned_union<0, Mountain, Teleport, Finish, Enemy, Blank, Frontier>::type CellSlot;
+            std::vector<CellSlot> arena;
+            bool cells_built;
+
+        //Lazily built boards only. Slots are added to the deque as cells are built, so none of them ever moves.
+            bool lazy;
+            std::deque<CellSlot> lazy_arena;
+            std::unordered_map<int, Space*> lazy_cells;     //Every Space built so far, Frontiers included, by cell index
+            std::unordered_map<Space*, int> lazy_indices;   //The same Spaces the other way round, for getIndex()
+            std::vector<int> portal_cells;                  //Indices of the portals, in the order they are paired
+
+        string base_template;                   //The template the board was built from, 'A' and '.' only
+        string layout;                          //The filled-in template (see populate_board())
+        string to_permute;                      //Scratch space for place_pieces(), kept to reuse its memory
+        std::vector<Space*> teleports;          //Scratch space for populate_board(), kept to reuse its memory
+
         int player_start[2];                    //Starting position of the player
+        Space* start;                           //The Space at player_start
+        int map_id;                             //Index of the template the board was built from
+
+        //See getDistances(). The matrices of the templates this board has held are kept in "distance_cache", and
+        //"distances" is rebuilt from the current one when the pieces move.
+            std::unique_ptr<DistanceCache> distance_cache;
+            std::unique_ptr<BoardDistances> distances;
+            bool distances_current;
+            string distance_template;           //The template "distances" was last built from...
+            int distance_rows;                  //...and its number of rows
 
         //Called by constructor. Used to choose a template for and create the board.
-        string choose_map();
-        void   populate_board(string);
+        MapTemplate choose_map(std::default_random_engine&);
+        void   build_from_file(std::default_random_engine&);
+        void   build(const MapTemplate&, std::default_random_engine&);
+        void   populate_board(const string&);
+        void   populate_lazy(const string&);
+        void   destroy_cells();
+
+        //Lazily built boards only, see the description above
+            Space* lazy_cell(int cell);         //The Space at "cell", a new Frontier if nothing has been built there
+            virtual Space* materialize(int64_t cell);   //Replaces the Frontier at "cell" with its real Space
+            char   lazy_sprite(int cell);
+
+        static void fill_template(string& map, string& to_permute, std::default_random_engine& rd);
+
+        //Sets the eight neighbour pointers of every Space. Specialised for the common board sizes, see Grid.hpp.
+            struct CellLinker;
+            template <class GridType> void link_cells(const GridType& grid);
 
     public:
         Board();
+        Board(std::default_random_engine& rd);          //Same as Board(), but every random choice comes from "rd"
+        Board(const std::vector<MapTemplate>& maps, std::default_random_engine& rd);   //Chooses from already loaded templates
+        Board(const MapPack& pack, std::default_random_engine& rd);                     //Chooses from a binary map pack
+
+        static const int LAZY_CELLS = 4096;     //Boards with more cells than this are built lazily
+
+        //Helpers shared with the tools that build boards without a Board object (solver, simulators).
+            static std::vector<MapTemplate> load_maps(const string& filename = "maps.txt");
+            static MapTemplate parse_map(const string& line);
+            static string place_pieces(string map, std::default_random_engine& rd);
+            static Space* construct_cell(char piece, void* slot);      //Builds the Space for a layout character in "slot"
+            static char   hidden_sprite(char piece);                    //How a layout character is drawn before it's visited
+
+        //Open cells a template of "cells" cells needs for every piece fill_template() places: a start, then a vault,
+        //two portals and nine enemies for every 36 cells. A template with fewer would lose some of them.
+            static int min_open(int cells){return 1 + 12 * std::max(1, cells / 36);};
+
+        //Rebuild the board in place for a new game without allocating. reshuffle() keeps the template and places
+        //the player, vault, portals and enemies again. reset() chooses a new template, as the constructor does.
+            void reshuffle(std::default_random_engine& rd);
+            void reset(const std::vector<MapTemplate>& maps, std::default_random_engine& rd);
+
+        //Rebuild the cells from a filled-in layout of the current template's size, such as another board's getLayout().
+        //Throws a string if the size doesn't match. The second version takes the size and template id with it, as a
+        //saved game does (see Snapshot.hpp).
+            void load_layout(const string& layout);
+            void load_layout(const string& layout, int rows, int cols, int map_id);
+
+        //Cells by index (row * cols + col). getCell() builds the cell on a lazily built board, along with Frontiers
+        //for its neighbours, so a search over the board should use findCell(), which returns nullptr if the cell
+        //hasn't been built. getIndex() returns -1 for a Space that isn't on this board.
+            Space* getCell(int cell){return lazy ? materialize(cell) : board[cell / cols][cell % cols];};
+            Space* findCell(int cell);
+            int    getIndex(Space* space);
+
+        Space* getPlayerStart(){return start;};
+
+        //Fewest moves between any two cells (see DistanceCache.hpp), or nullptr on a lazily built board. Worked out
+        //the first time they're asked for after the board is built or rebuilt.
+            const BoardDistances* getDistances();
 
-        Space* getPlayerStart(){return board[player_start[0]][player_start[1]];};
+        //Getter methods used to build other representations of the same board (see BitBoard.hpp)
+            const string& getLayout(){return layout;};
+            int getRows(){return rows;};
+            int getCols(){return cols;};
+            int getMapId(){return map_id;};
+            bool isLazy(){return lazy;};
+            int  getBuiltCells(){return lazy ? lazy_cells.size() : rows * cols;};   //Spaces constructed, Frontiers included
 
         void showBoard();
+        void showBoard(std::ostream& out);      //Same as showBoard(), written to "out" instead of the terminal
+        void getSprites(string& sprites);       //Every cell's sprite, top row first, in the order showBoard() draws them
 
-        ~Board();
+        ~Board();           //Defined in Board.cpp, where DistanceCache is complete
 };
 
 #endif
@@ -0,0 +1,653 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for board difficulty scores and the DifficultyCache.
+******************************************************************************************************************************************************/
+#include "Difficulty.hpp"
+#include "Simulation.hpp"
+#include "DistanceCache.hpp"
+#include "WagerTable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char MAGIC[4] = {'T', 'Q', 'D', 'C'};
+const uint16_t NO_PATH = 0xFFFF;
+
+/*****************************************************************************************************************************************************
+** DifficultyCache constructor and destructor
+******************************************************************************************************************************************************/
+DifficultyCache::DifficultyCache(const string& filename, int games, int strength) :
+    filename(filename), games(games), strength(strength), fd(-1), data(nullptr), length(0), header(nullptr),
+    slots(nullptr), hits(0), misses(0){
+
+    bool exists = (::access(filename.c_str(), F_OK) == 0);
+    if (!map(filename, INITIAL_CAPACITY, !exists)){
+        throw string("ERROR: Could not open ") + filename + "\n";
+    }
+
+    uint64_t capacity = header->capacity;
+    if (std::memcmp(header->magic, MAGIC, 4) != 0 || header->version != VERSION || capacity == 0
+        || (capacity & (capacity - 1)) != 0 || length != sizeof(Header) + capacity * sizeof(Slot)){
+        unmap();
+        throw string("ERROR: ") + filename + " is not a difficulty cache\n";
+    }
+    if ((int)header->games != games || (int)header->strength != strength){
+        unmap();
+        throw string("ERROR: ") + filename + " holds scores for other games or strength\n";
+    }
+}
+
+DifficultyCache::~DifficultyCache(){
+    unmap();
+}
+
+/*****************************************************************************************************************************************************
+** map(const string& path, uint64_t capacity, bool create)
+** Maps the file at "path" for reading and writing. With "create", first makes it an empty table of "capacity" slots.
+******************************************************************************************************************************************************/
+bool DifficultyCache::map(const string& path, uint64_t capacity, bool create){
+    fd = ::open(path.c_str(), create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+    if (fd < 0){
+        return false;
+    }
+
+    if (create){
+        length = sizeof(Header) + capacity * sizeof(Slot);
+        if (::ftruncate(fd, length) != 0){          //The new file reads as zeros: every slot empty
+            unmap();
+            return false;
+        }
+    }
+    else {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(Header)){
+            unmap();
+            return false;
+        }
+        length = info.st_size;
+    }
+
+    void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED){
+        unmap();
+        return false;
+    }
+    data = static_cast<unsigned char*>(mapping);
+    header = reinterpret_cast<Header*>(data);
+    slots = reinterpret_cast<Slot*>(data + sizeof(Header));
+
+    if (create){
+        std::memcpy(header->magic, MAGIC, 4);
+        header->version = VERSION;
+        header->games = games;
+        header->strength = strength;
+        header->capacity = capacity;
+        header->count = 0;
+    }
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** unmap()
+******************************************************************************************************************************************************/
+void DifficultyCache::unmap(){
+    if (data){
+        munmap(data, length);
+        data = nullptr;
+        header = nullptr;
+        slots = nullptr;
+    }
+    if (fd >= 0){
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+/*****************************************************************************************************************************************************
+** grow()
+** Copies every entry into a table twice the size in a new file, then renames it over the old one. Until the rename,
+** the old file is untouched, so a crash part way leaves the old cache as it was.
+******************************************************************************************************************************************************/
+void DifficultyCache::grow(){
+    string temporary = filename + ".tmp";
+    uint64_t old_capacity = header->capacity;
+
+    std::remove(temporary.c_str());                 //Left over from a crash part way through growing
+    DifficultyCache bigger(temporary, games, strength);
+    bigger.unmap();
+    if (!bigger.map(temporary, old_capacity * 2, true)){
+        throw string("ERROR: Could not grow ") + filename + "\n";
+    }
+
+    for (uint64_t index = 0; index < old_capacity; index++){
+        if (slots[index].key){
+            *bigger.find(slots[index].key) = slots[index];
+            bigger.header->count++;
+        }
+    }
+
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0){
+        std::remove(temporary.c_str());
+        throw string("ERROR: Could not grow ") + filename + "\n";
+    }
+
+    //Take over the bigger table's mapping
+    unmap();
+    std::swap(fd, bigger.fd);
+    std::swap(data, bigger.data);
+    std::swap(length, bigger.length);
+    std::swap(header, bigger.header);
+    std::swap(slots, bigger.slots);
+}
+
+/*****************************************************************************************************************************************************
+** Slot* find(uint64_t key)
+******************************************************************************************************************************************************/
+DifficultyCache::Slot* DifficultyCache::find(uint64_t key){
+    uint64_t mask = header->capacity - 1;
+    for (uint64_t index = key & mask; ; index = (index + 1) & mask){
+        if (slots[index].key == key || slots[index].key == 0){
+            return &slots[index];
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** bool lookup(const string& layout, int rows, int cols, Difficulty& difficulty)
+******************************************************************************************************************************************************/
+bool DifficultyCache::lookup(const string& layout, int rows, int cols, Difficulty& difficulty){
+    Slot* slot = find(hash(layout, rows, cols));
+    if (!slot->key){
+        return false;
+    }
+    difficulty.win_rate = slot->win_rate;
+    difficulty.vault_distance = (slot->vault_distance == NO_PATH) ? -1 : slot->vault_distance;
+    difficulty.enemies_in_reach = slot->enemies_in_reach;
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** Difficulty score(const string& layout, int rows, int cols)
+******************************************************************************************************************************************************/
+Difficulty DifficultyCache::score(const string& layout, int rows, int cols){
+    Difficulty difficulty;
+    if (lookup(layout, rows, cols, difficulty)){
+        hits++;
+        return difficulty;
+    }
+    misses++;
+
+    if (!scratch){
+        std::vector<MapTemplate> maps(1, MapTemplate{rows, cols, layout});
+        std::default_random_engine rd(0);
+        scratch.reset(new Board(maps, rd));
+    }
+    difficulty = evaluate(*scratch, layout, rows, cols, games, strength);
+    insert(layout, rows, cols, difficulty);
+    return difficulty;
+}
+
+/*****************************************************************************************************************************************************
+** insert(const string& layout, int rows, int cols, const Difficulty& difficulty)
+******************************************************************************************************************************************************/
+void DifficultyCache::insert(const string& layout, int rows, int cols, const Difficulty& difficulty){
+    uint64_t key = hash(layout, rows, cols);
+    Slot* slot = find(key);
+    if (!slot->key){
+        if (4 * (header->count + 1) > 3 * header->capacity){
+            grow();
+            slot = find(key);
+        }
+        header->count++;
+    }
+
+    slot->win_rate = difficulty.win_rate;
+    slot->vault_distance = (difficulty.vault_distance < 0) ? NO_PATH : difficulty.vault_distance;
+    slot->enemies_in_reach = std::min(difficulty.enemies_in_reach, 255);
+    slot->reserved = 0;
+    slot->key = key;                    //Last, see the description in Difficulty.hpp
+}
+
+/*****************************************************************************************************************************************************
+** uint64_t hash(const string& layout, int rows, int cols)
+******************************************************************************************************************************************************/
+uint64_t DifficultyCache::hash(const string& layout, int rows, int cols){
+    uint64_t value = 14695981039346656037ULL;
+    unsigned char size[4] = {(unsigned char)rows, (unsigned char)(rows >> 8), (unsigned char)cols, (unsigned char)(cols >> 8)};
+    for (unsigned char byte : size){
+        value = (value ^ byte) * 1099511628211ULL;
+    }
+    for (char character : layout){
+        value = (value ^ (unsigned char)character) * 1099511628211ULL;
+    }
+    return value ? value : 1;
+}
+
+/*****************************************************************************************************************************************************
+** distances(Board& board, std::vector<int>& moves)
+** Looked up in the board's distance table, which follows the same rules as Space::move_player(): mountains and edges
+** block, and stepping onto a portal lands on its partner, which is where the distance is counted. A lazily built
+** board has no table, and its layout is searched breadth-first by the same rules instead. Searching its Spaces
+** would build every cell the search reaches.
+******************************************************************************************************************************************************/
+void DifficultyCache::distances(Board& board, std::vector<int>& moves){
+    int cells = board.getRows() * board.getCols();
+    int start = board.getIndex(board.getPlayerStart());
+
+    const BoardDistances* table = board.getDistances();
+    if (table){
+        moves.resize(cells);
+        for (int cell = 0; cell < cells; cell++){
+            moves[cell] = table->distance(start, cell);
+        }
+        return;
+    }
+
+    //Portals are paired in the order they appear, and one left without a partner can't be stepped onto
+    const int UNPAIRED = -2;
+    const string& layout = board.getLayout();
+    std::vector<int> partner(cells, -1);
+    int last_portal = -1;
+    for (int cell = 0; cell < cells; cell++){
+        if (layout[cell] != 'O'){
+            continue;
+        }
+        if (last_portal < 0){
+            last_portal = cell;
+            partner[cell] = UNPAIRED;
+        }
+        else {
+            partner[cell] = last_portal;
+            partner[last_portal] = cell;
+            last_portal = -1;
+        }
+    }
+
+    Grid grid(board.getRows(), board.getCols());
+    moves.assign(cells, -1);
+    std::vector<int> queue(1, start);
+    moves[start] = 0;
+
+    for (size_t next = 0; next < queue.size(); next++){
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+            int cell = grid.neighbour(queue[next], dir);
+            if (cell < 0 || layout[cell] == 'A' || partner[cell] == UNPAIRED){
+                continue;
+            }
+            if (partner[cell] >= 0){
+                cell = partner[cell];
+            }
+            if (moves[cell] < 0){
+                moves[cell] = moves[queue[next]] + 1;
+                queue.push_back(cell);
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** Difficulty evaluate(Board& board, const string& layout, int rows, int cols, int games, int strength)
+******************************************************************************************************************************************************/
+Difficulty DifficultyCache::evaluate(Board& board, const string& layout, int rows, int cols, int games, int strength){
+    board.load_layout(layout, rows, cols, board.getMapId());
+    std::vector<int> moves;
+    Difficulty difficulty = measure(board, strength, moves);
+
+    int wins = play(board, layout, 0, games, strength);
+    difficulty.win_rate = games ? float(wins) / games : 0.0f;
+    return difficulty;
+}
+
+/*****************************************************************************************************************************************************
+** Difficulty measure(Board& board, int strength, std::vector<int>& moves)
+** Sets "moves" as distances() does and returns the board's vault distance and enemies in reach, with no win rate.
+******************************************************************************************************************************************************/
+Difficulty DifficultyCache::measure(Board& board, int strength, std::vector<int>& moves){
+    Difficulty difficulty = {0.0f, -1, 0};
+    const string& layout = board.getLayout();
+
+    distances(board, moves);
+    for (size_t cell = 0; cell < moves.size(); cell++){
+        if (moves[cell] < 0){
+            continue;
+        }
+        if (layout[cell] == '!'){
+            difficulty.vault_distance = moves[cell];
+        }
+        else if (layout[cell] == 'e' && moves[cell] <= strength){
+            difficulty.enemies_in_reach++;
+        }
+    }
+    return difficulty;
+}
+
+/*****************************************************************************************************************************************************
+** int play(Board& board, const string& layout, int first, int last, int strength)
+** Plays games [first, last) of a board's score and returns how many were won. Game g is played by GreedyPolicy(g)
+** with battle rolls from an engine seeded with g, on a fresh copy of the layout, so the games can be played a few
+** at a time and add up to the same score.
+******************************************************************************************************************************************************/
+int DifficultyCache::play(Board& board, const string& layout, int first, int last, int strength){
+    int wins = 0;
+    for (int game = first; game < last; game++){
+        board.load_layout(layout);
+        GreedyPolicy policy(game);
+        std::default_random_engine rd(game);
+        wins += play_headless(&policy, &board, rd, strength, MAX_MOVES).won;
+    }
+    return wins;
+}
+
+/*****************************************************************************************************************************************************
+** BoardSelector constructor
+******************************************************************************************************************************************************/
+BoardSelector::BoardSelector(const std::vector<MapTemplate>& maps, DifficultyCache* cache, float tolerance, int games, int strength) :
+    maps(maps), cache(cache), games(cache ? cache->getGames() : games), strength(cache ? cache->getStrength() : strength),
+    tolerance(tolerance), selections(0), misses(0), candidates(0), ruled_out(0), scored(0), games_played(0){
+}
+
+/*****************************************************************************************************************************************************
+** int strongest_after_battle(int strength)
+** The most strength points a battle won can leave a player who starts it with "strength": the best of every wager
+** a battle allows, won against an attack of 1. Strength can't fall below 0, so a large wager from a weak player
+** can leave it stronger than it was.
+******************************************************************************************************************************************************/
+static int strongest_after_battle(int strength){
+    int best = 0;
+    for (int wager = 1; wager <= WagerTable::MAX_POWER; wager++){
+        best = std::max(best, std::max(strength - wager, 0) + wager / 2);
+    }
+    return best;
+}
+
+/*****************************************************************************************************************************************************
+** bool route_affordable(Board& board, int strength, const std::vector<int>& moves)
+** True if some order of 4 enemies and then the vault can be walked on "strength", at best. A battle is only fought
+** by a player who lands on the enemy with strength left, and a battle won leaves at most strongest_after_battle().
+** The walk between two stops is taken as short as the template's distances and the board's portals could make
+** it, which is never longer than the real one. Enemies are only kept apart from the one just beaten, not from
+** every one before it, which can only let more routes through. A lazily built board has no template distances,
+** so only its first battle is checked.
+******************************************************************************************************************************************************/
+static bool route_affordable(Board& board, int strength, const std::vector<int>& moves){
+    const string& layout = board.getLayout();
+    const BoardDistances* table = board.getDistances();
+    int vault = layout.find('!');
+
+    //strongest_after_battle() for every strength a player can have. A battle never leaves more than the starting
+    //strength or MAX_POWER.
+    std::vector<int> after(std::max(strength, WagerTable::MAX_POWER) + 1);
+    for (size_t points = 0; points < after.size(); points++){
+        after[points] = strongest_after_battle(points);
+    }
+
+    //Most strength left after winning the first battle at each enemy, -1 where it can't be fought
+    std::vector<int> enemies, left, next;
+    for (size_t cell = 0; cell < moves.size(); cell++){
+        if (layout[cell] == 'e' && moves[cell] >= 0){
+            enemies.push_back(cell);
+            left.push_back(strength - moves[cell] > 0 ? after[strength - moves[cell]] : -1);
+        }
+    }
+    if (!table){
+        return *std::max_element(left.begin(), left.end()) > 0;
+    }
+
+    //A walk that never teleports takes at least the template's distance. One that does first steps onto a portal
+    //that has a partner, and last lands on one, so it takes at least the fewest moves onto a portal from where it
+    //starts plus the fewest from a portal to where it ends.
+    const DistanceMatrix& matrix = table->getMatrix();
+    std::vector<int> portals;
+    for (size_t cell = 0; cell < layout.length(); cell++){
+        if (layout[cell] == 'O'){
+            portals.push_back(cell);
+        }
+    }
+    portals.resize(portals.size() & ~size_t(1));
+    size_t num_enemies = enemies.size();
+    enemies.push_back(vault);                   //The last stop, walked to like an enemy
+
+    std::vector<int> onto_portal(enemies.size(), -1), off_portal(enemies.size(), -1);
+    for (size_t stop = 0; stop < enemies.size(); stop++){
+        for (int portal : portals){
+            int onto = matrix.distance(enemies[stop], portal), off = matrix.distance(portal, enemies[stop]);
+            if (onto >= 0 && (onto_portal[stop] < 0 || onto < onto_portal[stop])){
+                onto_portal[stop] = onto;
+            }
+            if (off >= 0 && (off_portal[stop] < 0 || off < off_portal[stop])){
+                off_portal[stop] = off;
+            }
+        }
+    }
+    auto walk = [&](size_t from, size_t to){
+        int plain = matrix.distance(enemies[from], enemies[to]);
+        if (onto_portal[from] < 0 || off_portal[to] < 0){
+            return plain;
+        }
+        int teleported = onto_portal[from] + off_portal[to];
+        return (plain < 0) ? teleported : std::min(plain, teleported);
+    };
+
+    for (int battle = 2; battle <= 4; battle++){
+        next.assign(num_enemies, -1);
+        for (size_t to = 0; to < num_enemies; to++){
+            for (size_t from = 0; from < num_enemies; from++){
+                if (from == to || left[from] <= 0){
+                    continue;
+                }
+                int steps = walk(from, to);
+                if (steps >= 0 && left[from] - steps > 0){
+                    next[to] = std::max(next[to], after[left[from] - steps]);
+                }
+            }
+        }
+        left.swap(next);
+    }
+
+    //Landing on the vault with 4 keys wins even with no strength left
+    for (size_t from = 0; from < num_enemies; from++){
+        int steps = (left[from] < 0) ? -1 : walk(from, num_enemies);
+        if (steps >= 0 && left[from] >= steps){
+            return true;
+        }
+    }
+    return false;
+}
+
+/*****************************************************************************************************************************************************
+** Bounds replay_bounds(Board& board, int strength)
+** A GreedyPolicy wagers what WagerTable.hpp gives, which for the shipped table is the enemy's maximum power, so
+** every battle it fights is won whatever the dice. Its moves then depend on the board alone until it falls back on
+** a random move, and every one of a board's games takes the same path, differing only in the strength each battle
+** costs. This plays that path once, with strength to spare so it can't end early, and follows the least and most
+** strength any of the games can have at each step. If even the weakest game reaches the vault, every game is won.
+** If even the strongest runs out of strength or moves, every game is lost. Returns [0, 1] if the path reaches a
+** random move, or a battle some game could lose, before either is known.
+******************************************************************************************************************************************************/
+static BoardSelector::Bounds replay_bounds(Board& board, int strength){
+    const int PLENTY = 1 << 20;                 //Strength of the replayed game, which never runs out
+    BoardSelector::Bounds unknown = {0.0f, 1.0f};
+
+    GreedyPolicy policy(0);
+    std::default_random_engine rd(0);
+    Player player(PLENTY, &policy, &rd);
+    Space* position = board.getPlayerStart();
+
+    //Least and most strength of the games still being played, and whether any game has been lost
+    int least = strength, most = strength;
+    bool any_lost = false;
+
+    for (int move = 0; move < DifficultyCache::MAX_MOVES; move++){
+        char key = policy.choose_move(&board, position, &player);
+        if (policy.getRandomMoves() > 0){
+            return unknown;
+        }
+
+        int keys = player.keys(), before = player.strength();
+        position = position->move_player(key, &player);
+        if (player.strength() == before){
+            continue;                           //Blocked, so it costs a move but no strength
+        }
+
+        //Every move costs 1 strength point. A game left with none is lost, unless that move won it.
+        if (player.won_game()){
+            float lower = any_lost ? 0.0f : 1.0f;
+            return BoardSelector::Bounds{lower, 1.0f};
+        }
+        if (most <= 1){
+            return BoardSelector::Bounds{0.0f, 0.0f};
+        }
+        any_lost = any_lost || least <= 1;
+        least = std::max(least - 1, 1);
+        most--;
+
+        if (player.keys() == keys){
+            if (player.strength() != before - 1){
+                return unknown;                 //A battle lost by the replayed game
+            }
+            continue;
+        }
+
+        //A battle, fought by every game still going. Each has strength in [least, most] and meets any power.
+        int after_least = PLENTY, after_most = 0;
+        for (int points = least; points <= most; points++){
+            for (int power = WagerTable::MIN_POWER; power <= WagerTable::MAX_POWER; power++){
+                int wager = WagerTable::best_wager(power, keys, points);
+                if (wager < power){
+                    return unknown;
+                }
+                int after = std::max(points - wager, 0) + wager / 2;
+                after_least = std::min(after_least, after);
+                after_most = std::max(after_most, after);
+            }
+        }
+        least = after_least;
+        most = after_most;
+    }
+    return BoardSelector::Bounds{0.0f, 0.0f};
+}
+
+/*****************************************************************************************************************************************************
+** Bounds bounds(Board& board, const Difficulty& measured, int strength, const std::vector<int>& moves)
+** A board can't be won if the vault or 4 enemies can't be reached, or if no route past 4 enemies to the vault can be
+** afforded (see route_affordable()). Otherwise its games are replayed once (see replay_bounds()), which settles
+** most boards as all won or all lost.
+******************************************************************************************************************************************************/
+BoardSelector::Bounds BoardSelector::bounds(Board& board, const Difficulty& measured, int strength, const std::vector<int>& moves){
+    Bounds lost = {0.0f, 0.0f};
+    if (measured.vault_distance < 0 || measured.enemies_in_reach < 4 || !route_affordable(board, strength, moves)){
+        return lost;
+    }
+    return replay_bounds(board, strength);
+}
+
+/*****************************************************************************************************************************************************
+** Bounds interval(int wins, int played, int games)
+** The win rate of a board that has won "wins" of the first "played" of its "games" games: a Wilson score interval,
+** narrowed to the rates the remaining games could still give. It is checked after every game, so it is wider than a
+** single 95% interval (z = 2.5 rather than 1.96) to keep boards that would score on target from being set aside.
+******************************************************************************************************************************************************/
+static BoardSelector::Bounds interval(int wins, int played, int games){
+    const double Z = 2.5;
+    double rate = double(wins) / played, spread = Z * Z / played;
+    double centre = (rate + spread / 2) / (1 + spread);
+    double half = Z * std::sqrt(rate * (1 - rate) / played + spread / (4 * played)) / (1 + spread);
+
+    BoardSelector::Bounds result;
+    result.lower = std::max(centre - half, double(wins) / games);
+    result.upper = std::min(centre + half, double(wins + games - played) / games);
+    return result;
+}
+
+/*****************************************************************************************************************************************************
+** bool select(Board& board, float target, std::default_random_engine& rd, Difficulty& difficulty)
+** Draws candidates while there is budget left for another, until one is scored within the tolerance of "target". A
+** candidate is played a game at a time, and set aside as soon as its interval rules the target out, so most never
+** get near a full score. On a miss the closest board found is loaded, without spending more games on it.
+******************************************************************************************************************************************************/
+bool BoardSelector::select(Board& board, float target, std::default_random_engine& rd, Difficulty& difficulty){
+    struct Candidate
+    {
+        string     layout;
+        int        rows, cols, map_id;
+        int        wins, played;            //Of its first games, "played" equals "games" once it is scored in full
+        Difficulty difficulty;
+        float      distance;                //From the target, by the win rate of the games played so far
+    };
+
+    selections++;
+    float low = target - tolerance, high = target + tolerance;
+    int games_left = MAX_GAMES;
+    Candidate best;
+    best.played = 0;
+    best.distance = 2.0f;
+
+    while (!(best.played == games && best.distance <= tolerance) && games_left >= CANDIDATE_COST){
+        board.reset(maps, rd);
+        candidates++;
+        games_left -= CANDIDATE_COST;
+        Candidate candidate = {board.getLayout(), board.getRows(), board.getCols(), board.getMapId(), 0, 0, Difficulty(), 2.0f};
+        Bounds bound;
+
+        if (cache && cache->lookup(candidate.layout, candidate.rows, candidate.cols, candidate.difficulty)){
+            candidate.played = games;
+        }
+        else if (candidate.difficulty = DifficultyCache::measure(board, strength, moves),
+                 bound = bounds(board, candidate.difficulty, strength, moves), bound.lower == bound.upper){
+            //An exact bound: every game is won or every game lost, so it is a full score without playing any
+            candidate.played = games;
+            candidate.wins = bound.lower * games;
+            candidate.difficulty.win_rate = bound.lower;
+            if (cache){
+                cache->insert(candidate.layout, candidate.rows, candidate.cols, candidate.difficulty);
+            }
+            if (bound.lower < low || bound.lower > high){
+                ruled_out++;
+            }
+            else {
+                scored++;
+            }
+        }
+        else {
+            //Play it a game at a time while it could still be close enough. The last candidate may finish over budget.
+            bool close = true;
+            while (close && candidate.played < games){
+                candidate.wins += DifficultyCache::play(board, candidate.layout, candidate.played, candidate.played + 1, strength);
+                candidate.played++;
+                Bounds rate = interval(candidate.wins, candidate.played, games);
+                close = (rate.upper >= low && rate.lower <= high);
+            }
+            games_left -= candidate.played;
+            games_played += candidate.played;
+            candidate.difficulty.win_rate = float(candidate.wins) / candidate.played;
+
+            if (candidate.played < games){
+                ruled_out++;
+            }
+            else {
+                scored++;
+                if (cache){
+                    cache->insert(candidate.layout, candidate.rows, candidate.cols, candidate.difficulty);
+                }
+            }
+        }
+
+        candidate.distance = std::abs(candidate.difficulty.win_rate - target);
+        if (candidate.distance < best.distance || (candidate.distance == best.distance && candidate.played > best.played)){
+            best = candidate;
+        }
+    }
+
+    bool found = (best.played == games && best.distance <= tolerance);
+    misses += !found;
+    board.load_layout(best.layout, best.rows, best.cols, best.map_id);
+    difficulty = best.difficulty;
+    return found;
+}
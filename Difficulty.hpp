@@ -0,0 +1,183 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for board difficulty scores and the DifficultyCache that keeps them. A
+** board's Difficulty is worked out from its filled-in layout (see Board::getLayout()):
+    - win_rate:          the share of "games" seeded games a GreedyPolicy wins on it. Game g uses seed g for its
+                         battle rolls, so the same board always gets the same score.
+    - vault_distance:    fewest moves from the start to the vault, through portals, -1 if it can't be reached
+    - enemies_in_reach:  enemies the player can reach from the start within its starting strength
+** Scoring a board plays every one of its games, so the scores are kept in a DifficultyCache, a hash table in a
+** memory-mapped file that persists between runs. A board already in the cache costs one lookup.
+
+** Cache file layout (host byte order):
+    - Header:  "TQDC", uint32 version, uint32 games, uint32 starting strength, uint64 capacity, uint64 count, padded
+               to 64 bytes. A cache is only used for scores worked out with the same games and strength.
+    - Slots:   "capacity" (a power of 2) Slot structs, found by linear probing from hash & (capacity - 1). A key of 0
+               marks an empty slot. The key is written last, so a slot torn by a crash reads as empty.
+** The table is rebuilt at twice the size, in a new file renamed over the old one, once it is three-quarters full.
+
+** A BoardSelector draws boards until it finds one whose win rate is close to a target. Playing every candidate's
+** games would cost far too much, so each is checked against cheaper bounds on its win rate first, and set aside as
+** soon as they rule the target out:
+    - From the board alone: a player who can't reach the vault or 4 enemies, or can't afford any route past 4
+      enemies to the vault (through portals) on its starting strength, never wins.
+    - From one replay: the greedy player's battles can't be lost, so until it has to move at random all of a
+      board's games take the same path. Following the least and most strength they can have along it usually shows
+      that every game is won, or every game lost.
+    - From the games played so far: a confidence interval on the win rate (Wilson score, wide enough to be checked
+      after every game), and the range of win rates still possible before the rest of the games are played.
+** A candidate the interval hasn't ruled out is played on until it is scored in full. Bounds that settle a board,
+** where the lower equals the upper, are exact rather than estimates, so such a board is cached as fully scored;
+** no other bound is ever cached. A selection stops drawing candidates once its MAX_GAMES budget, about a
+** millisecond's play, is spent, and reports a miss if none came within the tolerance. Boards close to an even
+** chance are rare (about 1 draw in 35 is within 5 points of 50%), so targets there miss far more often than
+** targets near the ends.
+******************************************************************************************************************************************************/
+#ifndef DIFFICULTY_HPP
+#define DIFFICULTY_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include "Board.hpp"
+
+struct Difficulty
+{
+    float win_rate;
+    int   vault_distance;
+    int   enemies_in_reach;
+};
+
+class DifficultyCache
+{
+    public:
+        static const uint32_t VERSION = 1;
+        static const int MAX_MOVES = 1000;      //Moves a scored game may last before it counts as lost
+        static const uint64_t INITIAL_CAPACITY = 1024;
+
+    private:
+        struct Header
+        {
+            char     magic[4];
+            uint32_t version, games, strength;
+            uint64_t capacity, count;
+            char     padding[32];
+        };
+        static_assert(sizeof(Header) == 64, "DifficultyCache::Header must be 64 bytes");
+
+        struct Slot
+        {
+            uint64_t key;
+            float    win_rate;
+            uint16_t vault_distance;        //0xFFFF if the vault can't be reached
+            uint8_t  enemies_in_reach;
+            uint8_t  reserved;
+        };
+
+        string filename;
+        int games, strength;
+
+        int fd;
+        unsigned char* data;                //The mapped file
+        size_t length;
+        Header* header;
+        Slot* slots;
+
+        long hits, misses;
+        std::unique_ptr<Board> scratch;     //Rebuilt in place for each board that is scored
+
+        DifficultyCache(const DifficultyCache&);        //Not copyable: owns the mapping
+        DifficultyCache& operator=(const DifficultyCache&);
+
+        bool map(const string& path, uint64_t capacity, bool create);
+        void unmap();
+        void grow();
+        Slot* find(uint64_t key);           //The key's slot, or the empty slot it would go in
+
+    public:
+        //Opens the cache in "filename", creating it if there isn't one. Throws a string if the file isn't a cache,
+        //or was made with other games or strength, or can't be created.
+            DifficultyCache(const string& filename, int games = 64, int strength = 30);
+        ~DifficultyCache();
+
+        //The board's score, from the cache or worked out and added to it. Not thread-safe.
+            Difficulty score(const string& layout, int rows, int cols);
+
+        //Sets "difficulty" and returns true if the board is in the cache
+            bool lookup(const string& layout, int rows, int cols, Difficulty& difficulty);
+
+        //Adds a score worked out elsewhere, e.g. by a BoardSelector, replacing the board's old one if it has one
+            void insert(const string& layout, int rows, int cols, const Difficulty& difficulty);
+
+        int      getGames(){return games;};
+        int      getStrength(){return strength;};
+        long     getHits(){return hits;};
+        long     getMisses(){return misses;};
+        uint64_t size(){return header->count;};
+        uint64_t capacity(){return header->capacity;};
+
+        //64-bit FNV-1a hash of the board's size and layout. Never 0.
+            static uint64_t hash(const string& layout, int rows, int cols);
+
+        //Works out a board's score without the cache. "board" is rebuilt from the layout.
+            static Difficulty evaluate(Board& board, const string& layout, int rows, int cols, int games, int strength);
+
+        //A board's vault distance and enemies in reach, as it is built, with a win rate of 0. Sets "moves" as
+        //distances() does.
+            static Difficulty measure(Board& board, int strength, std::vector<int>& moves);
+
+        //Plays games [first, last) of a board's score on "board" and returns the number won
+            static int play(Board& board, const string& layout, int first, int last, int strength);
+
+        //Fewest moves from the start to every cell of "board" as it is built, through portals, -1 where it can't
+        //be reached. Used by evaluate() and for cheap bounds on a board.
+            static void distances(Board& board, std::vector<int>& moves);
+};
+
+class BoardSelector
+{
+    public:
+        static const int CANDIDATE_COST = 6;    //Drawing a candidate and working out its bounds costs about this many games
+        static const int MAX_GAMES = 256;       //Games one selection may play, counting each candidate drawn as CANDIDATE_COST
+
+        //Lowest and highest win rate a board can have
+            struct Bounds
+            {
+                float lower, upper;
+            };
+
+    private:
+        const std::vector<MapTemplate>& maps;
+        DifficultyCache* cache;
+        int games, strength;
+        float tolerance;
+        std::vector<int> moves;                 //distances() scratch space
+
+        long selections, misses, candidates, ruled_out, scored, games_played;
+
+    public:
+        //maps  - Templates to draw boards from. Must outlive the selector.
+        //cache - Where full scores are looked up and kept, nullptr for none. Its games and strength are used.
+            BoardSelector(const std::vector<MapTemplate>& maps, DifficultyCache* cache = nullptr, float tolerance = 0.05f,
+                          int games = 64, int strength = 30);
+
+        //Rebuilds "board" in place, drawing candidates from "rd" as Board::reset() does, until one's win rate is
+        //within the tolerance of "target" [0, 1], and sets "difficulty" to its score. Returns false if the budget
+        //ran out first, leaving the closest board found and its win rate over the games it was played.
+            bool select(Board& board, float target, std::default_random_engine& rd, Difficulty& difficulty);
+
+        //Bounds on the win rate of "board", as it is built, without playing its games. "measured" and "moves" are
+        //the board's DifficultyCache::measure(). Plays one game on "board", which must be loaded again after. A
+        //board the bounds settle, with lower == upper, wins every game or loses every game: that is its exact score.
+            static Bounds bounds(Board& board, const Difficulty& measured, int strength, const std::vector<int>& moves);
+
+        long getSelections(){return selections;};
+        long getMisses(){return misses;};               //Selections that found no board within the tolerance
+        long getCandidates(){return candidates;};
+        long getRuledOut(){return ruled_out;};          //Candidates set aside before being scored in full
+        long getScored(){return scored;};
+        long getGamesPlayed(){return games_played;};
+};
+
+#endif
@@ -0,0 +1,485 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the DistanceMatrix, DistanceCache and BoardDistances classes.
+******************************************************************************************************************************************************/
+#include "DistanceCache.hpp"
+#include "MapPack.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char MAGIC[4] = {'T', 'Q', 'D', 'M'};
+const size_t HEADER_SIZE = 24;
+const size_t RECORD_HEADER_SIZE = 2;        //In uint16s
+
+const uint16_t DistanceMatrix::UNREACHABLE;
+
+/*****************************************************************************************************************************************************
+** Helpers for reading and writing little-endian integers at unaligned positions
+******************************************************************************************************************************************************/
+static uint64_t read_uint(const unsigned char* bytes, int width){
+    uint64_t value = 0;
+    for (int index = width - 1; index >= 0; index--){
+        value = (value << 8) | bytes[index];
+    }
+    return value;
+}
+
+static void write_uint(std::ofstream& file, uint64_t value, int width){
+    for (int index = 0; index < width; index++){
+        file.put(char(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+static bool little_endian(){
+    uint16_t probe = 1;
+    return *reinterpret_cast<unsigned char*>(&probe) == 1;
+}
+
+/*****************************************************************************************************************************************************
+** DistanceMatrix::build(const MapTemplate& map, std::vector<uint16_t>& record)
+** Runs a breadth-first search from every open cell. A move towards a mountain or off the board isn't an edge.
+** Region numbers are assigned in cell order, each to the cells reached by the first search that finds them.
+** A shortest walk visits each open cell at most once, so it is always less than UNREACHABLE moves.
+******************************************************************************************************************************************************/
+void DistanceMatrix::build(const MapTemplate& map, std::vector<uint16_t>& record){
+    int cells = map.rows * map.cols;
+    if (map.rows <= 0 || map.cols <= 0 || cells > Board::LAZY_CELLS || (int)map.cells.length() != cells){
+        throw string("ERROR: Distance tables support templates of 1 to " + std::to_string(Board::LAZY_CELLS) + " cells\n");
+    }
+
+    record.assign(record_size(cells), UNREACHABLE);
+    record[0] = map.rows;
+    record[1] = map.cols;
+    uint16_t* regions = &record[RECORD_HEADER_SIZE];
+    uint16_t* distances = regions + cells;
+
+    Grid grid(map.rows, map.cols);
+    std::vector<int> frontier(cells);
+    int next_region = 0;
+
+    for (int start = 0; start < cells; start++){
+        if (map.cells[start] == 'A'){
+            continue;
+        }
+
+        uint16_t* from_start = distances + size_t(start) * cells;
+        from_start[start] = 0;
+        int head = 0, tail = 0;
+        frontier[tail++] = start;
+
+        while (head < tail){
+            int cell = frontier[head++];
+            for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+                int next = grid.neighbour(cell, dir);
+                if (next < 0 || map.cells[next] == 'A' || from_start[next] != UNREACHABLE){
+                    continue;
+                }
+                from_start[next] = from_start[cell] + 1;
+                frontier[tail++] = next;
+            }
+        }
+
+        if (regions[start] == UNREACHABLE){
+            for (int reached = 0; reached < tail; reached++){
+                regions[frontier[reached]] = next_region;
+            }
+            next_region++;
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** DistanceMatrix::decode(const uint16_t* record)
+******************************************************************************************************************************************************/
+DistanceMatrix DistanceMatrix::decode(const uint16_t* record){
+    DistanceMatrix matrix;
+    matrix.rows = record[0];
+    matrix.cols = record[1];
+    matrix.regions = record + RECORD_HEADER_SIZE;
+    matrix.distances = matrix.regions + matrix.cells();
+    return matrix;
+}
+
+/*****************************************************************************************************************************************************
+** DistanceCache()
+******************************************************************************************************************************************************/
+DistanceCache::DistanceCache(){
+    pack = nullptr;
+    maps = nullptr;
+    data = index = nullptr;
+    length = 0;
+    count = 0;
+}
+
+/*****************************************************************************************************************************************************
+** DistanceCache(const std::vector<MapTemplate>& maps)
+******************************************************************************************************************************************************/
+DistanceCache::DistanceCache(const std::vector<MapTemplate>& maps){
+    pack = nullptr;
+    this->maps = &maps;
+    data = index = nullptr;
+    length = 0;
+    count = maps.size();
+}
+
+/*****************************************************************************************************************************************************
+** DistanceCache(const MapPack& pack, const string& filename)
+******************************************************************************************************************************************************/
+DistanceCache::DistanceCache(const MapPack& pack, const string& filename){
+    this->pack = &pack;
+    maps = nullptr;
+    data = index = nullptr;
+    length = 0;
+    count = pack.size();
+    open(filename, count);
+}
+
+DistanceCache::~DistanceCache(){
+    if (data){
+        munmap(const_cast<unsigned char*>(data), length);
+    }
+}
+
+/*****************************************************************************************************************************************************
+** bool open(const string& filename, uint64_t count)
+** Maps the cache file and checks that it holds "count" templates. Nothing is read until a matrix is asked for,
+** and the operating system pages records in as they're used. Each record is checked by get().
+******************************************************************************************************************************************************/
+bool DistanceCache::open(const string& filename, uint64_t count){
+    if (!little_endian()){
+        return false;
+    }
+
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < (off_t)HEADER_SIZE){
+        ::close(descriptor);
+        throw string("ERROR: " + filename + " is not a distance cache\n");
+    }
+
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED){
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(mapping);
+    length = info.st_size;
+
+    uint64_t index_offset = read_uint(data + 16, 8);
+    if (std::memcmp(data, MAGIC, 4) != 0 || read_uint(data + 4, 4) != VERSION
+        || read_uint(data + 8, 8) != count || index_offset > length || index_offset % 8 || count > (length - index_offset) / 8){
+        munmap(const_cast<unsigned char*>(data), length);
+        data = nullptr;
+        length = 0;
+        throw string("ERROR: " + filename + " is not a distance cache for this map pack\n");
+    }
+    index = data + index_offset;
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** DistanceMatrix get(uint64_t map_id)
+** A mapped record must start on a uint16 boundary past the header and hold the whole matrix its size calls for.
+******************************************************************************************************************************************************/
+DistanceMatrix DistanceCache::get(uint64_t map_id){
+    if (map_id >= count){
+        throw string("ERROR: There is no template " + std::to_string(map_id) + " in the distance cache\n");
+    }
+
+    if (data){
+        uint64_t offset = read_uint(index + 8 * map_id, 8);
+        if (offset < HEADER_SIZE || offset % 2 || offset > length - 2 * RECORD_HEADER_SIZE){
+            throw string("ERROR: Distance cache record " + std::to_string(map_id) + " is out of range\n");
+        }
+        const uint16_t* record = reinterpret_cast<const uint16_t*>(data + offset);
+        int cells = int(record[0]) * record[1];
+        if (cells == 0 || cells > Board::LAZY_CELLS || 2 * DistanceMatrix::record_size(cells) > length - offset){
+            throw string("ERROR: Distance cache record " + std::to_string(map_id) + " is out of range\n");
+        }
+        return DistanceMatrix::decode(record);
+    }
+
+    std::unordered_map<uint64_t, std::vector<uint16_t>>::iterator found = computed.find(map_id);
+    if (found == computed.end()){
+        std::vector<uint16_t> record;
+        DistanceMatrix::build(pack ? pack->get(map_id) : (*maps)[map_id], record);
+        found = computed.emplace(map_id, std::move(record)).first;
+    }
+    return DistanceMatrix::decode(found->second.data());
+}
+
+/*****************************************************************************************************************************************************
+** DistanceMatrix get(const MapTemplate& map)
+******************************************************************************************************************************************************/
+DistanceMatrix DistanceCache::get(const MapTemplate& map){
+    string key = std::to_string(map.rows) + "x" + std::to_string(map.cols) + ":" + map.cells;
+
+    std::unordered_map<string, std::vector<uint16_t>>::iterator found = computed_templates.find(key);
+    if (found == computed_templates.end()){
+        std::vector<uint16_t> record;
+        DistanceMatrix::build(map, record);
+        found = computed_templates.emplace(key, std::move(record)).first;
+    }
+    return DistanceMatrix::decode(found->second.data());
+}
+
+/*****************************************************************************************************************************************************
+** bool write(const string& filename, const MapPack& pack)
+** Same layout as a map pack: records straight after the header, then the index once every offset is known.
+******************************************************************************************************************************************************/
+bool DistanceCache::write(const string& filename, const MapPack& pack){
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file << string(HEADER_SIZE, '\0');
+    uint64_t position = HEADER_SIZE;
+
+    std::vector<uint64_t> offsets;
+    offsets.reserve(pack.size());
+    std::vector<uint16_t> record;
+
+    for (uint64_t map_id = 0; map_id < pack.size() && file; map_id++){
+        DistanceMatrix::build(pack.get(map_id), record);
+        offsets.push_back(position);
+        for (uint16_t value : record){
+            write_uint(file, value, 2);
+        }
+        position += 2 * record.size();
+    }
+
+    //Keep the index 8-byte aligned
+    while (position % 8){
+        file.put('\0');
+        position++;
+    }
+
+    uint64_t index_offset = position;
+    for (uint64_t offset : offsets){
+        write_uint(file, offset, 8);
+    }
+
+    file.seekp(0);
+    file.write(MAGIC, 4);
+    write_uint(file, VERSION, 4);
+    write_uint(file, offsets.size(), 8);
+    write_uint(file, index_offset, 8);
+
+    file.close();
+    return !file.fail();
+}
+
+/*****************************************************************************************************************************************************
+** assign(const DistanceMatrix& matrix, const string& layout)
+** Portals are paired in the order they appear in the layout, as Board does. A portal left over has no partner.
+** The same board again, as when several games are played on one layout, keeps what has been searched.
+******************************************************************************************************************************************************/
+void BoardDistances::assign(const DistanceMatrix& matrix, const string& layout){
+    if (matrix.distances == this->matrix.distances && layout == this->layout){
+        return;
+    }
+    this->matrix = matrix;
+    this->layout = layout;
+    int cells = matrix.cells();
+
+    portals.clear();
+    partner.assign(cells, -1);
+    for (int cell = 0; cell < cells && cell < (int)layout.length(); cell++){
+        if (layout[cell] == 'O'){
+            portals.push_back(cell);
+            partner[cell] = UNPAIRED;
+        }
+    }
+    for (size_t index = 0; index + 1 < portals.size(); index += 2){
+        partner[portals[index]] = portals[index + 1];
+        partner[portals[index + 1]] = portals[index];
+    }
+
+    searched.resize(cells);
+    searched_to.resize(cells);
+    for (int cell = 0; cell < cells; cell++){
+        searched[cell].clear();
+        searched_to[cell].clear();
+    }
+}
+
+/*****************************************************************************************************************************************************
+** search_from(const GridType& grid, const string& layout, const int* partner, int unpaired, uint16_t* distances,
+**             int* frontier, int from)
+** Breadth-first search over the board from "from", following the same rules as Space::move_player(). A template
+** over the grid, so the searches on the common board sizes get constant dimensions (see Grid.hpp). "partner" is
+** BoardDistances' own, with "unpaired" marking a portal that can't be stepped onto.
+******************************************************************************************************************************************************/
+template <class GridType>
+static void search_from(const GridType& grid, const string& layout, const int* partner, int unpaired, uint16_t* distances,
+                        int* frontier, int from){
+    distances[from] = 0;
+    int head = 0, tail = 0;
+    frontier[tail++] = from;
+
+    while (head < tail){
+        int cell = frontier[head++];
+        int row = cell / grid.cols(), col = cell % grid.cols();
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+            int next = grid.neighbour(row, col, dir);
+            if (next < 0 || layout[next] == 'A' || partner[next] == unpaired){
+                continue;
+            }
+            if (partner[next] >= 0){
+                next = partner[next];
+            }
+            if (distances[next] == DistanceMatrix::UNREACHABLE){
+                distances[next] = distances[cell] + 1;
+                frontier[tail++] = next;
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** search_to(const GridType& grid, const string& layout, const int* partner, uint16_t* distances, int* frontier, int to)
+** Breadth-first search over the moves of the board in reverse. A cell is landed on by stepping onto it, or onto its
+** partner if it is a portal, so the cells one move further away are the open neighbours of that cell.
+******************************************************************************************************************************************************/
+template <class GridType>
+static void search_to(const GridType& grid, const string& layout, const int* partner, uint16_t* distances, int* frontier,
+                      int to){
+    distances[to] = 0;
+    int head = 0, tail = 0;
+    if (layout[to] != 'A'){
+        frontier[tail++] = to;
+    }
+
+    while (head < tail){
+        int cell = frontier[head++];
+        int entrance = (partner[cell] == -1) ? cell : partner[cell];
+        if (entrance < 0){
+            continue;
+        }
+        int row = entrance / grid.cols(), col = entrance % grid.cols();
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+            int previous = grid.neighbour(row, col, dir);
+            if (previous < 0 || layout[previous] == 'A' || distances[previous] != DistanceMatrix::UNREACHABLE){
+                continue;
+            }
+            distances[previous] = distances[cell] + 1;
+            frontier[tail++] = previous;
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** const std::vector<uint16_t>& search(int from)
+** Kept for the next query from the same cell.
+******************************************************************************************************************************************************/
+const std::vector<uint16_t>& BoardDistances::search(int from) const {
+    std::vector<uint16_t>& distances = searched[from];
+    if (!distances.empty()){
+        return distances;
+    }
+
+    distances.assign(matrix.cells(), DistanceMatrix::UNREACHABLE);
+    frontier.resize(matrix.cells());
+    with_grid(matrix.rows, matrix.cols, [&](const auto& grid){
+        search_from(grid, layout, partner.data(), UNPAIRED, distances.data(), frontier.data(), from);
+    });
+    return distances;
+}
+
+/*****************************************************************************************************************************************************
+** const std::vector<uint16_t>& towards(int to)
+** Kept for the next query towards the same cell.
+******************************************************************************************************************************************************/
+const std::vector<uint16_t>& BoardDistances::towards(int to) const {
+    std::vector<uint16_t>& distances = searched_to[to];
+    if (!distances.empty()){
+        return distances;
+    }
+
+    distances.assign(matrix.cells(), DistanceMatrix::UNREACHABLE);
+    frontier.resize(matrix.cells());
+    with_grid(matrix.rows, matrix.cols, [&](const auto& grid){
+        search_to(grid, layout, partner.data(), distances.data(), frontier.data(), to);
+    });
+    return distances;
+}
+
+/*****************************************************************************************************************************************************
+** bool walkable(int from, int to)
+** True if the template's distance from "from" to "to" is also the length of a walk that doesn't pass over a portal
+** on the way: some shortest walk in the template avoids every portal other than the two ends.
+******************************************************************************************************************************************************/
+bool BoardDistances::walkable(int from, int to) const {
+    int moves = matrix.distance(from, to);
+    if (moves < 0){
+        return true;
+    }
+    for (int portal : portals){
+        if (portal == from || portal == to){
+            continue;
+        }
+        int in = matrix.distance(from, portal), out = matrix.distance(portal, to);
+        if (in >= 0 && out >= 0 && in + out == moves){
+            return false;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** int distance(int from, int to)
+** A shortest walk either avoids the portals, or walks to the first portal it steps onto and goes on from that
+** portal's partner, whose distances are searched in full the first time a walk through it could be the shortest.
+** The template's matrix gives each walk up to the first portal, or a lower bound on it when a portal could lie on
+** the way. So the shortest of these is the distance as long as one of the walks that make it up is clear of
+** portals; otherwise the board is searched from "from".
+******************************************************************************************************************************************************/
+int BoardDistances::distance(int from, int to) const {
+    if (from == to){
+        return 0;
+    }
+    if (layout[from] == 'A'){
+        return -1;
+    }
+
+    //Already searched, or a walk from a portal, which may step back onto it
+    if (!searched[from].empty() || !searched_to[to].empty() || partner[from] != -1){
+        uint16_t moves = searched_to[to].empty() ? search(from)[to] : searched_to[to][from];
+        return (moves == DistanceMatrix::UNREACHABLE) ? -1 : moves;
+    }
+
+    int best = (partner[to] == -1) ? matrix.distance(from, to) : -1;      //A portal is only landed on through another
+    bool exact = (best < 0 || walkable(from, to));
+    for (int portal : portals){
+        if (partner[portal] < 0){
+            continue;
+        }
+        int in = matrix.distance(from, portal);
+        if (in < 0 || (best >= 0 && in >= best)){
+            continue;
+        }
+        uint16_t out = search(partner[portal])[to];
+        if (out == DistanceMatrix::UNREACHABLE || (best >= 0 && in + out > best)){
+            continue;
+        }
+        if (best < 0 || in + out < best){
+            exact = false;
+        }
+        best = in + out;
+        exact = exact || walkable(from, portal);
+    }
+
+    if (!exact){
+        uint16_t moves = search(from)[to];
+        return (moves == DistanceMatrix::UNREACHABLE) ? -1 : moves;
+    }
+    return best;
+}
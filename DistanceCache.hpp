@@ -0,0 +1,154 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the distance tables. A DistanceMatrix holds the fewest moves between
+** every pair of cells of one template, found by a breadth-first search over the 8-neighbour graph from every open
+** cell, and a reachability index numbering the open regions of the template. A DistanceCache hands out the matrix
+** of any template in a map pack, reading it from a cache file beside the pack when there is one.
+
+** Portals are placed on each board rather than in the template, so BoardDistances adds the shortcut through a
+** particular board's portals to its template's matrix. A query is then a few table lookups instead of a search.
+** Board::getDistances() keeps one for the board being played, which the solver, GreedyPolicy and the difficulty
+** scores use.
+
+** Cache file layout (all integers little-endian):
+    - Header:  "TQDM", uint32 version, uint64 number of templates, uint64 offset of the index
+    - Index:   one uint64 per template, the offset of its record
+    - Records: uint16 rows, uint16 cols, one uint16 region number per cell, then one uint16 distance per pair of
+      cells, row "from" by column "to", with 65535 for a mountain or an unreachable cell. Records are used in place,
+      so a cache file is only mapped on a little-endian machine; elsewhere the matrices are computed.
+******************************************************************************************************************************************************/
+#ifndef DISTANCECACHE_HPP
+#define DISTANCECACHE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Board.hpp"
+
+class MapPack;
+
+//A view of one template's distances. The values belong to the DistanceCache it came from.
+struct DistanceMatrix
+{
+    static const uint16_t UNREACHABLE = 65535;
+
+    int rows, cols;
+    const uint16_t* regions;            //One per cell
+    const uint16_t* distances;          //cells * cells
+
+    int cells() const {return rows * cols;};
+
+    //Moves needed to step onto "to" from "from", or -1 if it can't be reached
+        int distance(int from, int to) const {
+            uint16_t moves = distances[from * cells() + to];
+            return (moves == UNREACHABLE) ? -1 : moves;
+        };
+
+    //True if both cells are open and in the same region
+        bool connected(int from, int to) const {
+            return regions[from] != UNREACHABLE && regions[from] == regions[to];
+        };
+
+    //Fills "record" with the record of "map", as laid out in the cache file. Throws a string for a template of more
+    //than Board::LAZY_CELLS cells, since larger boards are built lazily and the matrix would be too big to keep.
+        static void build(const MapTemplate& map, std::vector<uint16_t>& record);
+
+    //Reads a record built by build() or stored in a cache file
+        static DistanceMatrix decode(const uint16_t* record);
+        static size_t record_size(int cells){return 2 + cells + size_t(cells) * cells;};     //In uint16s
+};
+
+class DistanceCache
+{
+    private:
+        const MapPack* pack;                            //Where templates come from: a pack...
+        const std::vector<MapTemplate>* maps;           //...or templates already loaded (neither for get(const MapTemplate&))
+
+        //The cache file, if one is mapped
+            const unsigned char* data;
+            size_t length;
+            const unsigned char* index;
+            uint64_t count;
+
+        //Matrices computed because there was no cache file, kept for later queries, by id and by template
+            std::unordered_map<uint64_t, std::vector<uint16_t>> computed;
+            std::unordered_map<string, std::vector<uint16_t>> computed_templates;
+
+        DistanceCache(const DistanceCache&);            //Not copyable: owns the mapping
+        DistanceCache& operator=(const DistanceCache&);
+
+        bool open(const string& filename, uint64_t count);
+
+    public:
+        static const uint32_t VERSION = 2;
+
+        //Matrices are computed the first time each template is asked for. The first version only answers
+        //get(const MapTemplate&).
+            DistanceCache();
+            explicit DistanceCache(const std::vector<MapTemplate>& maps);
+
+        //Maps "filename" if it is a cache for "pack". Otherwise, matrices are computed the first time each template
+        //is asked for. Throws a string if the file exists but doesn't match the pack.
+            DistanceCache(const MapPack& pack, const string& filename);
+
+        ~DistanceCache();
+
+        bool is_mapped() const {return data != nullptr;};
+
+        //The matrix of template "map_id". Not thread-safe unless the cache is mapped. Throws a string if there is no
+        //such template or its record doesn't fit in the cache file.
+            DistanceMatrix get(uint64_t map_id);
+
+        //The matrix of any template, computed the first time a template with the same cells is asked for
+            DistanceMatrix get(const MapTemplate& map);
+
+        //Where the cache for a pack is kept, e.g. "maps.pack.dist"
+            static string filename_for(const string& pack_name){return pack_name + ".dist";};
+
+        //Computes the matrix of every template in "pack" and writes them to "filename".
+            static bool write(const string& filename, const MapPack& pack);
+};
+
+//Distances on one board: its template's matrix plus the shortcuts through the board's portals. Stepping onto one
+//portal lands the player on its partner, so a walk may be cut short by stepping onto a portal, and a walk can't
+//pass over a portal cell the way the template's matrix assumes.
+class BoardDistances
+{
+    private:
+        static const int UNPAIRED = -2;         //"partner" of a portal without one, which can't be stepped onto
+
+        DistanceMatrix matrix;
+        string layout;
+        std::vector<int> portals;               //Every portal cell
+        std::vector<int> partner;               //By cell: the portal a move onto it lands on, or -1 for any other cell
+
+        //Exact distances from a cell and to a cell, found by a breadth-first search over the board the first time
+        //they're needed. A portal's distances from it are needed by walks through its partner.
+            mutable std::vector<std::vector<uint16_t>> searched, searched_to;
+            mutable std::vector<int> frontier;
+
+        const std::vector<uint16_t>& search(int from) const;
+        bool walkable(int from, int to) const;
+
+    public:
+        BoardDistances(){matrix.distances = nullptr;};
+        BoardDistances(const DistanceMatrix& matrix, const string& layout){this->matrix.distances = nullptr; assign(matrix, layout);};
+
+        //Switches to another board, "layout" being its Board::getLayout(). Keeps the memory of the last one, and
+        //its searches too if the board is the same.
+            void assign(const DistanceMatrix& matrix, const string& layout);
+            const DistanceMatrix& getMatrix() const {return matrix;};
+
+        //Fewest moves to land on "to" from "from", or -1 if it can't be reached, following the same rules as
+        //Space::move_player(). A portal is landed on by stepping onto its partner. Not thread-safe: a query may
+        //search the board and keep the result.
+            int distance(int from, int to) const;
+
+        //Fewest moves to land on "to" from every cell, DistanceMatrix::UNREACHABLE where it can't be reached. One
+        //search backwards from "to", kept like distance()'s, which is cheaper than asking distance() from every cell.
+            const std::vector<uint16_t>& towards(int to) const;
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the GameSession class.
+******************************************************************************************************************************************************/
+#include "GameSession.hpp"
+#include "Metrics.hpp"
+#include "Snapshot.hpp"
+
+#include <cstdlib>
+
+/*****************************************************************************************************************************************************
+** GameSession constructor
+** maps - Templates to build boards from. Must outlive the session.
+** seed - Seeds the engine that makes every random choice in the session.
+******************************************************************************************************************************************************/
+GameSession::GameSession(const std::vector<MapTemplate>& maps, unsigned seed, int starting_strength) :
+    maps(maps), starting_strength(starting_strength), rd(seed), game_board(maps, rd),
+    player(starting_strength, &wagers, &rd), current_space(nullptr), phase(AWAIT_MOVE){
+
+    player.set_log(&out);
+    current_space = game_board.getPlayerStart();
+}
+
+/*****************************************************************************************************************************************************
+** start()
+******************************************************************************************************************************************************/
+const string& GameSession::start(){
+    switch (phase){
+        case AWAIT_MOVE:
+            show_turn();
+            break;
+        case AWAIT_WAGER:
+            out << "How many strength points would you like to wager? (1 to " << current_space->wager_limit() << ") ";
+            break;
+        case AWAIT_REPLAY:
+            out << "Would you like to play again? (y/n) ";
+            break;
+        case CLOSED:
+            break;
+    }
+    return flush();
+}
+
+/*****************************************************************************************************************************************************
+** save(const string& path, bool sync)
+******************************************************************************************************************************************************/
+bool GameSession::save(const string& path, bool sync){
+    return Snapshot::save(path, game_board, player, current_space, rd, phase, sync);
+}
+
+/*****************************************************************************************************************************************************
+** restore(const string& path)
+** The player keeps its log and the session's DeferredWager, which restoring doesn't change.
+******************************************************************************************************************************************************/
+bool GameSession::restore(const string& path){
+    int saved_phase;
+    Space* position = Snapshot::load(path, game_board, player, rd, &saved_phase, CLOSED + 1);
+    if (!position){
+        return false;
+    }
+    current_space = position;
+    phase = static_cast<Phase>(saved_phase);
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** input(const string& line)
+** Does what main() does with the same line of input in the same phase of the game. Invalid input gets the same
+** error message as the terminal game and leaves the phase unchanged.
+******************************************************************************************************************************************************/
+const string& GameSession::input(const string& line){
+    string response = line;
+    if (!response.empty() && response[response.size() - 1] == '\r'){
+        response.erase(response.size() - 1);
+    }
+
+    switch (phase){
+        case AWAIT_MOVE:
+            if (response.size() != 1 || move_direction(response[0]) < 0){
+                out << "Invalid move. Enter: ";
+                return flush();
+            }
+            out << endl;
+            current_space = current_space->move_player(response[0], &player);
+            break;
+
+        case AWAIT_WAGER: {
+            int limit = current_space->wager_limit();
+            char* end = nullptr;
+            long wager = std::strtol(response.c_str(), &end, 10);
+            if (response.empty() || *end != '\0' || wager < 1 || wager > limit){
+                out << "Response must be an integer between 1 and " << limit << " inclusive\nEnter: ";
+                return flush();
+            }
+            current_space->resolve_wager(&player, static_cast<int>(wager));
+            break;
+        }
+
+        case AWAIT_REPLAY:
+            if (response != "y" && response != "n"){
+                out << "Please respond with 'y' or 'n'. Enter: ";
+                return flush();
+            }
+            out << endl;
+            if (response == "y"){
+                new_game();
+                show_turn();
+            }
+            else {
+                phase = CLOSED;
+            }
+            return flush();
+
+        case CLOSED:
+            return flush();
+    }
+
+    //The move (or the battle it started) has finished, unless the enemy is still waiting for a wager.
+    if (current_space->awaiting_wager()){
+        phase = AWAIT_WAGER;
+    }
+    else if (player.status() && !player.won_game()){
+        show_turn();
+    }
+    else {
+        end_game();
+    }
+    return flush();
+}
+
+/*****************************************************************************************************************************************************
+** new_game()
+** Rebuilds the board in place and gives the player a fresh start.
+******************************************************************************************************************************************************/
+void GameSession::new_game(){
+    game_board.reset(maps, rd);
+    player = Player(starting_strength, &wagers, &rd);
+    player.set_log(&out);
+    current_space = game_board.getPlayerStart();
+}
+
+/*****************************************************************************************************************************************************
+** show_turn()
+** Writes the player's status, the board and the move prompt, as main() does at the start of each turn.
+******************************************************************************************************************************************************/
+void GameSession::show_turn(){
+    Metrics::Timer timer(Metrics::RENDER);
+    out << "---------------------------------------------------------------------------------------\n"
+    << "Player strength: " << player.strength() << "\n"
+    << "Player Keys: " << player.keys() << "\n" << endl;
+    game_board.showBoard(out);
+    out << "Enter your move: ";
+    phase = AWAIT_MOVE;
+}
+
+/*****************************************************************************************************************************************************
+** end_game()
+******************************************************************************************************************************************************/
+void GameSession::end_game(){
+    Metrics::count(player.won_game() ? Metrics::GAMES_WON : Metrics::GAMES_LOST);
+    out << "------------------------------------------------------------------------------------------\n";
+    if (player.won_game()){
+        out << "You win!\n";
+    }
+    else {
+        out << "Game over!\n";
+    }
+    out << "Would you like to play again? (y/n) ";
+    phase = AWAIT_REPLAY;
+}
+
+/*****************************************************************************************************************************************************
+** flush()
+** Moves the dialogue collected so far into the reply and empties the stream for the next line.
+******************************************************************************************************************************************************/
+const string& GameSession::flush(){
+    reply = out.str();
+    out.str("");
+    return reply;
+}
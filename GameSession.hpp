@@ -0,0 +1,69 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the GameSession class. A GameSession plays the same game as main(),
+** but it is driven one line of input at a time instead of reading from the terminal. Each call to input() returns
+** the text a player at the terminal would have seen in response, ending with the next prompt. Nothing blocks, so
+** a server can keep thousands of sessions open and resume each one whenever a line arrives for it.
+******************************************************************************************************************************************************/
+#ifndef GAMESESSION_HPP
+#define GAMESESSION_HPP
+
+#include <sstream>
+
+#include "Board.hpp"
+#include "Policy.hpp"
+
+class GameSession
+{
+    public:
+        enum Phase {AWAIT_MOVE, AWAIT_WAGER, AWAIT_REPLAY, CLOSED};
+
+    private:
+        //Leaves every battle waiting so its wager can arrive as a later line of input.
+            class DeferredWager : public Policy
+            {
+                public:
+                    virtual char choose_move(Board*, Space*, Player*){return '5';};
+                    virtual int  choose_wager(int, Player*){return DEFER;};
+            };
+
+        const std::vector<MapTemplate>& maps;
+        int starting_strength;
+
+        std::default_random_engine rd;          //Makes every random choice in the session, as in main()
+        DeferredWager wagers;
+        std::ostringstream out;                 //Collects the dialogue written while handling one line
+        string reply;
+
+        Board game_board;                       //Rebuilt in place for each new game
+        Player player;
+        Space* current_space;
+        Phase phase;
+
+        void new_game();
+        void show_turn();
+        void end_game();
+        const string& flush();
+
+    public:
+        GameSession(const std::vector<MapTemplate>& maps, unsigned seed, int starting_strength = 30);
+
+        //Returns the text shown when the session opens: the first board and move prompt, or after restore(), the
+        //prompt of the phase the game was saved in.
+            const string& start();
+
+        //Saves the game in progress to "path", or restores it from there, see Snapshot.hpp. save() returns false if
+        //the file can't be written, restore() if it can't be read, and restore() throws a string if it isn't a
+        //saved game.
+            bool save(const string& path, bool sync = true);
+            bool restore(const string& path);
+
+        //Handles one line of input (without its newline) and returns the response.
+            const string& input(const string& line);
+
+        Phase getPhase(){return phase;};
+        bool  finished() const {return phase == CLOSED;};
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This file describes the geometry of a board: how many rows and columns it has and which cell
+** lies in each of the eight directions from a given cell. Cells are numbered row * cols + col, and directions
+** are numbered in the order of the default controls "12346789" (SW, S, SE, W, E, NW, N, NE).
+
+** DIRECTIONS and move_direction() are constant expressions, so a move is resolved with table lookups rather than
+** a switch over the control characters.
+
+** FixedGrid is used for the common board sizes. Its dimensions are compile-time constants, so loops over cells and
+** directions are unrolled and the neighbour offsets fold into constants. Grid handles every other size at runtime.
+** Both have the same interface, so code written as a template over the grid type works with either one. Boards are
+** linked that way once, and BoardDistances searches that way on every query, which is where it pays: each Space
+** keeps pointers to its eight neighbours, so a move itself is a table lookup of the direction followed by one
+** pointer load, whatever the size of the board.
+******************************************************************************************************************************************************/
+#ifndef GRID_HPP
+#define GRID_HPP
+
+const int NUM_DIRECTIONS = 8;
+
+//Row and column step of a direction, and the default control that selects it
+struct Direction
+{
+    int  row, col;
+    char key;
+};
+
+constexpr Direction DIRECTIONS[NUM_DIRECTIONS] = {
+    {-1, -1, '1'}, {-1, 0, '2'}, {-1, 1, '3'},
+    { 0, -1, '4'},               { 0, 1, '6'},
+    { 1, -1, '7'}, { 1, 0, '8'}, { 1, 1, '9'}
+};
+
+//Direction selected by a default control ('1'-'4', '6'-'9'), or -1 for any other character
+constexpr int move_direction(char key){
+    return (key >= '1' && key <= '4') ? key - '1' : (key >= '6' && key <= '9') ? key - '2' : -1;
+}
+
+template <int ROWS, int COLS>
+struct FixedGrid
+{
+    static int rows()  {return ROWS;};
+    static int cols()  {return COLS;};
+    static int cells() {return ROWS * COLS;};
+
+    //Difference between the index of a cell and the index of its neighbour in direction "dir"
+    static constexpr int offset(int dir){return DIRECTIONS[dir].row * COLS + DIRECTIONS[dir].col;};
+
+    //Cell in direction "dir" from "cell", or -1 if that would leave the board
+    static int neighbour(int cell, int dir){
+        return neighbour(cell / COLS, cell % COLS, dir);
+    };
+
+    //Same as neighbour(cell, dir) for the cell at ("row", "col"), for loops that already know it
+    static int neighbour(int row, int col, int dir){
+        int next_row = row + DIRECTIONS[dir].row, next_col = col + DIRECTIONS[dir].col;
+        return (next_row < 0 || next_row >= ROWS || next_col < 0 || next_col >= COLS) ? -1 : next_row * COLS + next_col;
+    };
+};
+
+struct Grid
+{
+    int num_rows, num_cols;
+
+    Grid(int rows, int cols) : num_rows(rows), num_cols(cols){};
+
+    int rows()  const {return num_rows;};
+    int cols()  const {return num_cols;};
+    int cells() const {return num_rows * num_cols;};
+
+    int offset(int dir) const {return DIRECTIONS[dir].row * num_cols + DIRECTIONS[dir].col;};
+
+    int neighbour(int cell, int dir) const {
+        return neighbour(cell / num_cols, cell % num_cols, dir);
+    };
+
+    int neighbour(int row, int col, int dir) const {
+        int next_row = row + DIRECTIONS[dir].row, next_col = col + DIRECTIONS[dir].col;
+        return (next_row < 0 || next_row >= num_rows || next_col < 0 || next_col >= num_cols) ? -1 : next_row * num_cols + next_col;
+    };
+};
+
+//Calls "function" with a FixedGrid if the dimensions match one of the common sizes, otherwise with a Grid.
+template <class Function>
+void with_grid(int rows, int cols, Function function){
+    if (rows == 6 && cols == 6){
+        function(FixedGrid<6, 6>());
+    }
+    else if (rows == 8 && cols == 8){
+        function(FixedGrid<8, 8>());
+    }
+    else if (rows == 16 && cols == 16){
+        function(FixedGrid<16, 16>());
+    }
+    else {
+        function(Grid(rows, cols));
+    }
+}
+
+#endif
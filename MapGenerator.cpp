@@ -0,0 +1,93 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the MapGenerator class.
+******************************************************************************************************************************************************/
+#include "MapGenerator.hpp"
+#include "Board.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/*****************************************************************************************************************************************************
+** MapGenerator(double density, unsigned long seed, bool strict, int rows, int cols)
+******************************************************************************************************************************************************/
+MapGenerator::MapGenerator(double density, unsigned long seed, bool strict, int rows, int cols)
+    : shape(string(rows * cols, '.'), rows, cols), rd(seed){
+    this->strict = strict;
+    cells = rows * cols;
+    num_mountains = std::lround(density * cells);
+    rejections = 0;
+
+    min_open = Board::min_open(cells);
+    if (num_mountains > cells - min_open){
+        num_mountains = cells - min_open;
+    }
+}
+
+/*****************************************************************************************************************************************************
+** bool playable(BitBoard::Mask mountains)
+** Movement is symmetric, so a single flood fill from any open cell finds the whole connected area. In strict mode
+** the fill is then repeated with each open cell removed in turn.
+******************************************************************************************************************************************************/
+bool MapGenerator::playable(BitBoard::Mask mountains) const {
+    BitBoard::Mask open = shape.getCells() & ~mountains;
+
+    if (BitBoard::count(open) < min_open){
+        return false;
+    }
+    if (shape.flood_fill(open & -open, open) != open){
+        return false;
+    }
+    if (!strict){
+        return true;
+    }
+
+    for (BitBoard::Mask rest = open; rest; rest &= rest - 1){
+        BitBoard::Mask blocked = rest & -rest;
+        BitBoard::Mask remaining = open & ~blocked;
+        if (shape.flood_fill(remaining & -remaining, remaining) != remaining){
+            return false;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** BitBoard::Mask next()
+** Scatters the mountains uniformly at random and retries until the layout is playable, up to MAX_ATTEMPTS times.
+******************************************************************************************************************************************************/
+BitBoard::Mask MapGenerator::next(){
+    for (long attempt = 0; attempt < MAX_ATTEMPTS; attempt++){
+        BitBoard::Mask mountains = 0;
+        while (BitBoard::count(mountains) < num_mountains){
+            mountains |= BitBoard::bit(rd() % cells);
+        }
+
+        if (playable(mountains)){
+            return mountains;
+        }
+        rejections++;
+    }
+    throw string("ERROR: No playable layout found in " + std::to_string(MAX_ATTEMPTS) + " attempts. Try a lower "
+                 "mountain density" + (strict ? string(" or turn off strict mode") : string("")) + "\n");
+}
+
+/*****************************************************************************************************************************************************
+** string to_template(BitBoard::Mask mountains)
+******************************************************************************************************************************************************/
+string MapGenerator::to_template(BitBoard::Mask mountains) const {
+    //Boards other than 6x6 start with their dimensions, see Board::parse_map()
+    string prefix;
+    if (shape.getRows() != 6 || shape.getCols() != 6){
+        prefix = std::to_string(shape.getRows()) + "x" + std::to_string(shape.getCols()) + " ";
+    }
+
+    string map = prefix + string(cells, '.');
+    for (int cell = 0; cell < cells; cell++){
+        if (mountains & BitBoard::bit(cell)){
+            map[prefix.length() + cell] = 'A';
+        }
+    }
+    return map;
+}
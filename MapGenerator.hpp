@@ -0,0 +1,50 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the MapGenerator class, which randomly generates board templates
+** in the format of "maps.txt" ('A' for mountains, '.' for everything else).
+
+** Templates used to be made by hand (see mapmaker.hpp) so that an unplayable one couldn't be generated at random.
+** MapGenerator instead rejects any layout that fails a connectivity check. Layouts are BitBoard masks, so each
+** check is a handful of bitset flood fills rather than building a Space graph.
+******************************************************************************************************************************************************/
+#ifndef MAPGENERATOR_HPP
+#define MAPGENERATOR_HPP
+
+#include <random>
+
+#include "BitBoard.hpp"
+
+class MapGenerator
+{
+    private:
+        BitBoard shape;                 //Empty board of the right size, used for its shift and flood fill operations
+        int cells;
+        int num_mountains;              //Mountains placed on every template
+        int min_open;                   //Fewest open cells that leaves room for every piece placed by Board
+        bool strict;                    //See playable()
+
+        std::mt19937_64 rd;
+        long rejections;
+
+    public:
+        //"density" is the fraction of cells that are mountains. Boards of up to 64 cells are supported.
+        MapGenerator(double density, unsigned long seed, bool strict = false, int rows = 6, int cols = 6);
+
+        //True if every open cell can reach every other one. In strict mode this must also hold with any single
+        //open cell blocked: a portal blocks the cell it sits on (stepping onto it moves the player elsewhere), so
+        //a layout that relies on one cell to connect two areas can be cut in half by piece placement.
+        //Six of the ten hand-made templates would fail the strict check.
+            bool playable(BitBoard::Mask mountains) const;
+
+        static const long MAX_ATTEMPTS = 1000000;   //Layouts tried for one template before next() gives up
+
+        //Returns the mountain mask of the next playable layout. Throws a string if none of MAX_ATTEMPTS random
+        //layouts is playable, as happens when the density leaves the open cells disconnected.
+            BitBoard::Mask next();
+        string to_template(BitBoard::Mask mountains) const;
+
+        long getRejections(){return rejections;};
+};
+
+#endif
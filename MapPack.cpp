@@ -0,0 +1,207 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the MapPack and MapPackWriter classes.
+******************************************************************************************************************************************************/
+#include "MapPack.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char MAGIC[4] = {'T', 'Q', 'M', 'P'};
+const size_t HEADER_SIZE = 24;
+
+/*****************************************************************************************************************************************************
+** Helpers for reading and writing little-endian integers at unaligned positions
+******************************************************************************************************************************************************/
+static uint64_t read_uint(const unsigned char* bytes, int width){
+    uint64_t value = 0;
+    for (int index = width - 1; index >= 0; index--){
+        value = (value << 8) | bytes[index];
+    }
+    return value;
+}
+
+static void write_uint(std::ofstream& file, uint64_t value, int width){
+    for (int index = 0; index < width; index++){
+        file.put(char(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+/*****************************************************************************************************************************************************
+** MapPack()
+******************************************************************************************************************************************************/
+MapPack::MapPack(){
+    data = index = nullptr;
+    length = 0;
+    count = 0;
+}
+
+/*****************************************************************************************************************************************************
+** MapPack(const string& filename)
+******************************************************************************************************************************************************/
+MapPack::MapPack(const string& filename){
+    data = index = nullptr;
+    length = 0;
+    count = 0;
+    open(filename);
+}
+
+MapPack::~MapPack(){
+    close();
+}
+
+/*****************************************************************************************************************************************************
+** bool open(const string& filename)
+** Maps the whole file into memory and checks the header. The operating system pages records in as they're used.
+******************************************************************************************************************************************************/
+bool MapPack::open(const string& filename){
+    close();
+
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < (off_t)HEADER_SIZE){
+        ::close(descriptor);
+        throw string("ERROR: " + filename + " is not a map pack\n");
+    }
+
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED){
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(mapping);
+    length = info.st_size;
+
+    uint64_t index_offset = read_uint(data + 16, 8);
+    count = read_uint(data + 8, 8);
+
+    if (std::memcmp(data, MAGIC, 4) != 0 || read_uint(data + 4, 4) != VERSION
+        || index_offset > length || count > (length - index_offset) / 8){
+        close();
+        throw string("ERROR: " + filename + " is not a map pack\n");
+    }
+    index = data + index_offset;
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** close()
+******************************************************************************************************************************************************/
+void MapPack::close(){
+    if (data){
+        munmap(const_cast<unsigned char*>(data), length);
+    }
+    data = index = nullptr;
+    length = 0;
+    count = 0;
+}
+
+/*****************************************************************************************************************************************************
+** MapTemplate get(uint64_t map_id)
+** Looks the record up in the index and unpacks its cells. Throws a string if "map_id" is out of range, or if the
+** record's offset or size would read past the end of the file.
+******************************************************************************************************************************************************/
+MapTemplate MapPack::get(uint64_t map_id) const {
+    if (map_id >= count){
+        throw string("ERROR: Map " + std::to_string(map_id + 1) + " is not in the map pack\n");
+    }
+
+    uint64_t offset = read_uint(index + 8 * map_id, 8);
+    if (offset < HEADER_SIZE || offset > length - 4){
+        throw string("ERROR: Map pack record " + std::to_string(map_id + 1) + " is out of range\n");
+    }
+    const unsigned char* record = data + offset;
+
+    MapTemplate map;
+    map.rows = read_uint(record, 2);
+    map.cols = read_uint(record + 2, 2);
+
+    const unsigned char* bits = record + 4;
+    uint64_t cells = uint64_t(map.rows) * map.cols;
+    if (cells == 0 || (cells + 7) / 8 > length - offset - 4){
+        throw string("ERROR: Map pack record " + std::to_string(map_id + 1) + " is out of range\n");
+    }
+    map.cells.assign(cells, '.');
+    for (uint64_t cell = 0; cell < cells; cell++){
+        if (bits[cell >> 3] & (1 << (cell & 7))){
+            map.cells[cell] = 'A';
+        }
+    }
+    return map;
+}
+
+/*****************************************************************************************************************************************************
+** bool write(const string& filename, const std::vector<MapTemplate>& maps)
+******************************************************************************************************************************************************/
+bool MapPack::write(const string& filename, const std::vector<MapTemplate>& maps){
+    MapPackWriter writer(filename);
+    for (const MapTemplate& map : maps){
+        writer.add(map);
+    }
+    return writer.finish();
+}
+
+/*****************************************************************************************************************************************************
+** MapPackWriter(const string& filename)
+** Records are written straight after the header. The index goes at the end once every offset is known.
+******************************************************************************************************************************************************/
+MapPackWriter::MapPackWriter(const string& filename){
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    file << string(HEADER_SIZE, '\0');
+    position = HEADER_SIZE;
+}
+
+/*****************************************************************************************************************************************************
+** add(const MapTemplate& map)
+******************************************************************************************************************************************************/
+void MapPackWriter::add(const MapTemplate& map){
+    offsets.push_back(position);
+
+    write_uint(file, map.rows, 2);
+    write_uint(file, map.cols, 2);
+
+    string bits((map.cells.length() + 7) / 8, '\0');
+    for (size_t cell = 0; cell < map.cells.length(); cell++){
+        if (map.cells[cell] == 'A'){
+            bits[cell >> 3] |= char(1 << (cell & 7));
+        }
+    }
+    file.write(bits.data(), bits.size());
+
+    position += 4 + bits.size();
+}
+
+/*****************************************************************************************************************************************************
+** bool finish()
+******************************************************************************************************************************************************/
+bool MapPackWriter::finish(){
+    //Keep the index 8-byte aligned
+    while (position % 8){
+        file.put('\0');
+        position++;
+    }
+
+    uint64_t index_offset = position;
+    for (uint64_t offset : offsets){
+        write_uint(file, offset, 8);
+    }
+
+    file.seekp(0);
+    file.write(MAGIC, 4);
+    write_uint(file, MapPack::VERSION, 4);
+    write_uint(file, offsets.size(), 8);
+    write_uint(file, index_offset, 8);
+
+    file.close();
+    return !file.fail();
+}
@@ -0,0 +1,68 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the MapPack class, a binary alternative to "maps.txt" for map files
+** holding very large numbers of templates. The file is memory-mapped, and an index of record offsets makes
+** choosing template k a single lookup, no matter how many templates come before it.
+
+** File layout (all integers little-endian):
+    - Header:  "TQMP", uint32 version, uint64 number of templates, uint64 offset of the index
+    - Index:   one uint64 per template, the offset of its record
+    - Records: uint16 rows, uint16 cols, then one bit per cell (1 = mountain), row by row, padded to a whole byte
+******************************************************************************************************************************************************/
+#ifndef MAPPACK_HPP
+#define MAPPACK_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "Board.hpp"
+
+class MapPack
+{
+    private:
+        const unsigned char* data;      //Start of the memory-mapped file, nullptr if no file is open
+        size_t   length;
+        uint64_t count;
+        const unsigned char* index;
+
+        MapPack(const MapPack&);                //Not copyable: owns the mapping
+        MapPack& operator=(const MapPack&);
+
+    public:
+        static const uint32_t VERSION = 1;
+
+        MapPack();
+        explicit MapPack(const string& filename);   //Throws a string if the file exists but isn't a valid pack
+        ~MapPack();
+
+        bool open(const string& filename);          //Returns false if the file can't be opened
+        void close();
+
+        bool     is_open() const {return data != nullptr;};
+        uint64_t size()    const {return count;};
+
+        MapTemplate get(uint64_t map_id) const;     //Decodes template "map_id" (0-based). Throws a string if the record is bad.
+
+        //Writes "maps" as a pack. Returns false if the file can't be written.
+            static bool write(const string& filename, const std::vector<MapTemplate>& maps);
+};
+
+//Writes a pack one template at a time, so a text map file of any size can be converted without holding it in memory.
+class MapPackWriter
+{
+    private:
+        std::ofstream file;
+        std::vector<uint64_t> offsets;
+        uint64_t position;
+
+    public:
+        explicit MapPackWriter(const string& filename);
+        bool good(){return file.good();};
+
+        void add(const MapTemplate& map);
+        bool finish();                              //Writes the header and index. Returns false on a write error.
+};
+
+#endif
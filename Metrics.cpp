@@ -0,0 +1,143 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Metrics class.
+******************************************************************************************************************************************************/
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+bool Metrics::enabled_flag = false;
+Metrics::Clock::time_point Metrics::enabled_at;
+uint64_t Metrics::clock_overhead = 0;
+__thread Metrics::ThreadBlock* Metrics::block = nullptr;
+__thread Metrics::Timer* Metrics::innermost = nullptr;
+
+const char* PHASE_NAMES[Metrics::NUM_PHASES] = {"board_build", "map_read", "input_wait", "move", "combat", "render"};
+
+static std::mutex registry_lock;
+
+std::vector<Metrics::ThreadBlock*>& Metrics::registry(){
+    static std::vector<ThreadBlock*> blocks;
+    return blocks;
+}
+
+/*****************************************************************************************************************************************************
+** enable()
+** The clock overhead is the shortest of a few hundred back-to-back readings.
+******************************************************************************************************************************************************/
+void Metrics::enable(){
+    Clock::duration shortest = Clock::duration::max();
+    for (int sample = 0; sample < 256; sample++){
+        Clock::time_point first = Clock::now();
+        shortest = std::min(shortest, Clock::now() - first);
+    }
+    clock_overhead = std::chrono::duration_cast<std::chrono::nanoseconds>(shortest).count();
+
+    enabled_at = Clock::now();
+    enabled_flag = true;
+}
+
+/*****************************************************************************************************************************************************
+** ThreadBlock* register_thread()
+** Called once per thread. The block is never freed, so write() can still read it after the thread exits.
+******************************************************************************************************************************************************/
+Metrics::ThreadBlock* Metrics::register_thread(){
+    ThreadBlock* counts = new ThreadBlock;
+    for (int index = 0; index < NUM_COUNTERS; index++){
+        counts->counters[index].store(0);
+    }
+    for (int phase = 0; phase < NUM_PHASES; phase++){
+        counts->calls[phase].store(0);
+        counts->timed[phase].store(0);
+        counts->nanoseconds[phase].store(0);
+    }
+
+    std::lock_guard<std::mutex> guard(registry_lock);
+    registry().push_back(counts);
+    return counts;
+}
+
+/*****************************************************************************************************************************************************
+** write(std::ostream& out)
+******************************************************************************************************************************************************/
+void Metrics::write(std::ostream& out){
+    uint64_t counters[NUM_COUNTERS] = {}, calls[NUM_PHASES] = {}, timed[NUM_PHASES] = {}, nanoseconds[NUM_PHASES] = {};
+    {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        for (ThreadBlock* counts : registry()){
+            for (int index = 0; index < NUM_COUNTERS; index++){
+                counters[index] += counts->counters[index].load(std::memory_order_relaxed);
+            }
+            for (int phase = 0; phase < NUM_PHASES; phase++){
+                calls[phase] += counts->calls[phase].load(std::memory_order_relaxed);
+                timed[phase] += counts->timed[phase].load(std::memory_order_relaxed);
+                nanoseconds[phase] += counts->nanoseconds[phase].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    double uptime = std::chrono::duration<double>(Clock::now() - enabled_at).count();
+    uint64_t games = counters[GAMES_WON] + counters[GAMES_LOST];
+
+    out << "# HELP treasure_quest_phase_seconds_total Time spent in each phase of a game, not counting phases inside it, estimated from the timed calls.\n"
+    << "# TYPE treasure_quest_phase_seconds_total counter\n";
+    for (int phase = 0; phase < NUM_PHASES; phase++){
+        uint64_t overhead = timed[phase] * clock_overhead;
+        uint64_t measured = (nanoseconds[phase] > overhead) ? nanoseconds[phase] - overhead : 0;
+        double seconds = timed[phase] ? 1e-9 * measured * calls[phase] / timed[phase] : 0.0;
+        out << "treasure_quest_phase_seconds_total{phase=\"" << PHASE_NAMES[phase] << "\"} " << seconds << "\n";
+    }
+
+    out << "# HELP treasure_quest_phase_calls_total Times each phase was entered.\n"
+    << "# TYPE treasure_quest_phase_calls_total counter\n";
+    for (int phase = 0; phase < NUM_PHASES; phase++){
+        out << "treasure_quest_phase_calls_total{phase=\"" << PHASE_NAMES[phase] << "\"} " << calls[phase] << "\n";
+    }
+
+    out << "# HELP treasure_quest_moves_total Moves made, including blocked ones.\n"
+    << "# TYPE treasure_quest_moves_total counter\n"
+    << "treasure_quest_moves_total " << calls[MOVE] << "\n"
+    << "# HELP treasure_quest_teleports_total Moves that stepped onto a portal.\n"
+    << "# TYPE treasure_quest_teleports_total counter\n"
+    << "treasure_quest_teleports_total " << counters[TELEPORTS] << "\n"
+    << "# HELP treasure_quest_mountain_bumps_total Moves blocked by a mountain.\n"
+    << "# TYPE treasure_quest_mountain_bumps_total counter\n"
+    << "treasure_quest_mountain_bumps_total " << counters[MOUNTAIN_BUMPS] << "\n"
+    << "# HELP treasure_quest_edge_bumps_total Moves blocked by the edge of the board.\n"
+    << "# TYPE treasure_quest_edge_bumps_total counter\n"
+    << "treasure_quest_edge_bumps_total " << counters[EDGE_BUMPS] << "\n"
+    << "# HELP treasure_quest_battles_total Battles fought, by result.\n"
+    << "# TYPE treasure_quest_battles_total counter\n"
+    << "treasure_quest_battles_total{result=\"won\"} " << counters[BATTLES_WON] << "\n"
+    << "treasure_quest_battles_total{result=\"lost\"} " << counters[BATTLES_LOST] << "\n"
+    << "# HELP treasure_quest_games_total Games finished, by result.\n"
+    << "# TYPE treasure_quest_games_total counter\n"
+    << "treasure_quest_games_total{result=\"won\"} " << counters[GAMES_WON] << "\n"
+    << "treasure_quest_games_total{result=\"lost\"} " << counters[GAMES_LOST] << "\n"
+    << "# HELP treasure_quest_games_per_hour Games finished per hour since metrics were enabled.\n"
+    << "# TYPE treasure_quest_games_per_hour gauge\n"
+    << "treasure_quest_games_per_hour " << (uptime > 0.0 ? 3600.0 * games / uptime : 0.0) << "\n"
+    << "# HELP treasure_quest_uptime_seconds Seconds since metrics were enabled.\n"
+    << "# TYPE treasure_quest_uptime_seconds gauge\n"
+    << "treasure_quest_uptime_seconds " << uptime << "\n";
+}
+
+/*****************************************************************************************************************************************************
+** bool write(const std::string& path)
+******************************************************************************************************************************************************/
+bool Metrics::write(const std::string& path){
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::trunc);
+    write(file);
+    file.close();
+
+    if (file.fail() || std::rename(temporary.c_str(), path.c_str()) != 0){
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,158 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Metrics class, the instrumentation built into the game. When it is
+** enabled, it counts game events (moves, teleports, bumps into mountains and edges, battles and games) and times
+** the phases of a game: building the board, reading the map file, waiting for input, resolving moves, combat and
+** rendering. When it isn't, each hook is a single test of a flag.
+
+** Every thread gets its own block of counters the first time it records something. Only that thread writes to the
+** block, with plain relaxed loads and stores rather than locked instructions, and write() reads every block
+** without stopping the threads. Blocks are kept after their thread exits, so nothing it counted is lost.
+
+** Reading the clock takes longer than resolving a move, so moves and battles are timed one call in 1024 and board
+** construction one call in 64, and each total is scaled by the number of calls. The other phases are timed on every
+** call. The cost of reading the clock, measured when the metrics are enabled, is taken off every timed call. The
+** number of moves is the number of calls of the move phase rather than a separate counter.
+
+** Phases are exclusive. A phase entered inside another, such as a battle inside a move or waiting for a wager
+** inside a battle, has its time taken off the outer phase, so the totals add up to the time spent in all of them.
+** An inner phase therefore reads the clock whenever its outer phase is being timed, sampled or not.
+
+** write() produces Prometheus' text format, e.g. for node_exporter's textfile collector:
+    treasure_quest_phase_seconds_total{phase="move"}, treasure_quest_phase_calls_total{phase="move"},
+    treasure_quest_moves_total, treasure_quest_teleports_total, treasure_quest_mountain_bumps_total,
+    treasure_quest_edge_bumps_total, treasure_quest_battles_total{result="won"}, treasure_quest_games_total{result="won"},
+    treasure_quest_games_per_hour, treasure_quest_uptime_seconds
+******************************************************************************************************************************************************/
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Metrics
+{
+    public:
+        enum Phase {BOARD_BUILD, MAP_READ, INPUT_WAIT, MOVE, COMBAT, RENDER, NUM_PHASES};
+        enum Counter {TELEPORTS, MOUNTAIN_BUMPS, EDGE_BUMPS, BATTLES_WON, BATTLES_LOST, GAMES_WON, GAMES_LOST,
+                      NUM_COUNTERS};
+        class Timer;
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct alignas(64) ThreadBlock
+        {
+            std::atomic<uint64_t> counters[NUM_COUNTERS];
+            std::atomic<uint64_t> calls[NUM_PHASES],        //Every call of each phase...
+                                  timed[NUM_PHASES],        //...the calls that were timed...
+                                  nanoseconds[NUM_PHASES];  //...and how long those took
+        };
+
+        static bool enabled_flag;
+        static Clock::time_point enabled_at;
+        static uint64_t clock_overhead;                 //Nanoseconds one timed call adds by reading the clock, see enable()
+        static __thread ThreadBlock* block;             //__thread rather than thread_local: no initialisation check on each access
+        static __thread Timer* innermost;               //The thread's most recently started Timer that is still running
+
+        static std::vector<ThreadBlock*>& registry();   //Every thread's block, in the order they were registered
+        static ThreadBlock* register_thread();
+        static ThreadBlock& local(){
+            if (!block){
+                block = register_thread();
+            }
+            return *block;
+        };
+
+        //Only the owning thread writes, so there is no need for an atomic read-modify-write
+            static void add(std::atomic<uint64_t>& value, uint64_t amount){
+                value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            };
+
+    public:
+        //Turns the hooks on. Call before starting any threads that should be counted.
+            static void enable();
+            static bool enabled(){return enabled_flag;};
+
+        static void count(Counter counter, uint64_t amount = 1){
+            if (enabled_flag){
+                add(local().counters[counter], amount);
+            }
+        };
+
+        //Times the phase from construction to destruction. count() on a Timer is the same as Metrics::count(), without
+        //looking up the thread's block again, for events counted inside the phase.
+            class Timer
+            {
+                private:
+                    Phase phase;
+                    ThreadBlock* counts;                //nullptr if the metrics are off
+                    Timer* outer;                       //The Timer this one runs inside, if any
+                    bool timing;                        //This call is one of the phase's timed calls
+                    bool clocked;                       //The clock is read: the call is timed, or "outer" is clocked
+                    uint64_t inner;                     //Nanoseconds spent in Timers inside this one
+                    Clock::time_point start;
+
+                    Timer(const Timer&);
+                    Timer& operator=(const Timer&);
+
+                public:
+                    explicit Timer(Phase phase) : phase(phase), counts(nullptr), outer(nullptr), timing(false),
+                                                  clocked(false), inner(0){
+                        if (!enabled_flag){
+                            return;
+                        }
+                        counts = &local();
+                        uint64_t call = counts->calls[phase].load(std::memory_order_relaxed);
+                        counts->calls[phase].store(call + 1, std::memory_order_relaxed);
+
+                        uint64_t sample_mask = (phase == MOVE || phase == COMBAT) ? 1023 : (phase == BOARD_BUILD) ? 63 : 0;
+                        timing = (call & sample_mask) == 0;
+                        outer = innermost;
+                        innermost = this;
+                        clocked = timing || (outer && outer->clocked);
+                        if (clocked){
+                            start = Clock::now();
+                        }
+                    };
+
+                    void count(Counter counter){
+                        if (counts){
+                            add(counts->counters[counter], 1);
+                        }
+                    };
+
+                    //Timers end in the reverse of the order they start, since each is a local variable
+                    ~Timer(){
+                        if (!counts){
+                            return;
+                        }
+                        innermost = outer;
+                        if (!clocked){
+                            return;
+                        }
+
+                        uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                        if (timing){
+                            add(counts->nanoseconds[phase], (elapsed > inner) ? elapsed - inner : 0);
+                            add(counts->timed[phase], 1);
+                        }
+                        if (outer && outer->clocked){
+                            outer->inner += elapsed + clock_overhead;       //Reading the clock here is inside "outer" too
+                        }
+                    };
+            };
+
+        //Writes the totals of every thread in Prometheus' text format
+            static void write(std::ostream& out);
+
+        //Writes to "path" through a temporary file renamed over it, so a reader never sees half a file
+            static bool write(const std::string& path);
+};
+
+#endif
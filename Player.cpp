@@ -13,6 +13,39 @@
 Player::Player(int difficulty){
     strength_points = difficulty;
     victory = false;
+
+    policy = nullptr;
+    messages = &std::cout;
+    dice = nullptr;
+    hinting = false;
+}
+
+/*****************************************************************************************************************************************************
+** Player(int difficulty, Policy* policy)
+** Initializes a headless player. Moves and wagers are requested from "policy" and no game dialogue is written.
+******************************************************************************************************************************************************/
+Player::Player(int difficulty, Policy* policy){
+    strength_points = difficulty;
+    victory = false;
+
+    this->policy = policy;
+    messages = nullptr;
+    dice = nullptr;
+    hinting = false;
+}
+
+/*****************************************************************************************************************************************************
+** Player(int difficulty, Policy* policy, std::default_random_engine* dice)
+** Initializes a headless player whose battles draw from "dice" instead of seeding a new engine each time.
+******************************************************************************************************************************************************/
+Player::Player(int difficulty, Policy* policy, std::default_random_engine* dice){
+    strength_points = difficulty;
+    victory = false;
+
+    this->policy = policy;
+    messages = nullptr;
+    this->dice = dice;
+    hinting = false;
 }
 
 /*****************************************************************************************************************************************************
@@ -23,6 +56,16 @@ Player::Player(int difficulty){
 void Player::dec_strength(int lost){
     strength_points -= lost;
     if (strength_points < 0){
-        strength_points == 0;
+        strength_points = 0;
     }
 }
+
+/*****************************************************************************************************************************************************
+** restore(int strength, int keys, bool victory)
+** Sets the player's statistics to those of a saved game. The policy, log, engine and hint setting are kept.
+******************************************************************************************************************************************************/
+void Player::restore(int strength, int keys, bool victory){
+    strength_points = strength;
+    key_bag.assign(keys, 1);
+    this->victory = victory;
+}
@@ -8,6 +8,10 @@
 #define PLAYER_HPP
 
 #include <vector>
+#include <iostream>
+#include <random>
+
+class Policy;
 
 class Player
 {
@@ -16,8 +20,15 @@ class Player
         int strength_points;
         bool victory;
 
+        Policy* policy;                 //Chooses moves and wagers for the player. nullptr if a person is playing at the keyboard.
+        std::ostream* messages;         //Where game dialogue for this player is written. nullptr if the game runs headless.
+        std::default_random_engine* dice;   //Engine used for this player's battles. nullptr to seed a new one per battle.
+        bool hinting;                   //Whether battles suggest a wager, see Enemy::interact()
+
     public:
         Player(int);
+        Player(int, Policy*);           //Headless player: decisions come from the Policy and no dialogue is written.
+        Player(int, Policy*, std::default_random_engine*);
 
         //Getter methods for player attributes
             int  strength() {return strength_points;};
@@ -25,10 +36,19 @@ class Player
             bool status()   {return !(strength_points == 0);};
             bool won_game() {return victory;};
 
+            Policy*       controller() {return policy;};
+            std::ostream* log()        {return messages;};
+            std::default_random_engine* rng() {return dice;};
+            bool          hints()      {return hinting;};
+
         //Methods  to modify player attributes as a result of game events.
             void dec_strength(int);
             void add_key()      {key_bag.push_back(1);};
             void flip_victory() {victory = !victory;};
+            void set_rng(std::default_random_engine* dice) {this->dice = dice;};
+            void set_log(std::ostream* messages) {this->messages = messages;};
+            void set_hints(bool hinting) {this->hinting = hinting;};
+            void restore(int strength, int keys, bool victory);     //Used when restoring a saved game
 };
 
 #endif
@@ -0,0 +1,147 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Policy class and the policies derived from it.
+******************************************************************************************************************************************************/
+#include "Policy.hpp"
+#include "Board.hpp"
+#include "DistanceCache.hpp"
+#include "Grid.hpp"
+#include "Player.hpp"
+#include "WagerTable.hpp"
+
+#include <algorithm>
+
+/*****************************************************************************************************************************************************
+** RandomPolicy()
+** Seeds the policy's random number engine once, rather than on every decision.
+******************************************************************************************************************************************************/
+RandomPolicy::RandomPolicy(){
+    std::random_device seed_gen{};
+    rd.seed(seed_gen());
+}
+
+/*****************************************************************************************************************************************************
+** RandomPolicy(unsigned seed)
+** Used by the simulators, which give each worker thread its own seed.
+******************************************************************************************************************************************************/
+RandomPolicy::RandomPolicy(unsigned seed){
+    rd.seed(seed);
+}
+
+/*****************************************************************************************************************************************************
+** char RandomPolicy::choose_move(Board*, Space*, Player*)
+** Picks one of the eight directions at random.
+******************************************************************************************************************************************************/
+char RandomPolicy::choose_move(Board*, Space*, Player*){
+    return DIRECTIONS[std::uniform_int_distribution<int>{0, NUM_DIRECTIONS - 1}(rd)].key;
+}
+
+/*****************************************************************************************************************************************************
+** int RandomPolicy::choose_wager(int enemy_strength, Player*)
+** Wagers a random amount in the range [1, enemy_strength].
+******************************************************************************************************************************************************/
+int RandomPolicy::choose_wager(int enemy_strength, Player*){
+    return std::uniform_int_distribution<int>{1, enemy_strength}(rd);
+}
+
+/*****************************************************************************************************************************************************
+** int WagerPolicy::choose_wager(int enemy_strength, Player* player)
+** Looks the wager up by the enemy's maximum power and the player's keys and strength points. The player has already
+** paid for the move onto the enemy, which is what the table expects.
+******************************************************************************************************************************************************/
+int WagerPolicy::choose_wager(int enemy_strength, Player* player){
+    return WagerTable::best_wager(enemy_strength, player->keys(), player->strength());
+}
+
+/*****************************************************************************************************************************************************
+** int CautiousPolicy::choose_wager(int enemy_strength, Player* player)
+** The table's wager, which is always the enemy's maximum attack, capped at a share of the player's strength.
+******************************************************************************************************************************************************/
+int CautiousPolicy::choose_wager(int enemy_strength, Player* player){
+    int cap = std::max(1, player->strength() / STAKE_DIVISOR);
+    return std::min(WagerPolicy::choose_wager(enemy_strength, player), cap);
+}
+
+/*****************************************************************************************************************************************************
+** char GreedyPolicy::choose_move(Board* board, Space* position, Player* player)
+** Breadth-first search over the cells the player can reach, following the same rules as Space::move_player():
+** mountains and edges block, and a portal leads to the other portal. The first target found is the nearest.
+
+** The search stops at the nearest unvisited cell, usually a move or two away, which is cheaper than looking the
+** distance to every candidate up. The vault is a single target, so once the player has the keys the board's
+** distances to it (see Board::getDistances()) give the way there without a search on every move.
+
+** On a lazily built board the search only goes through cells that have been built. A Frontier can still be a
+** target, drawn as it would be before a visit, so the player heads for it and the move there builds it.
+******************************************************************************************************************************************************/
+char GreedyPolicy::choose_move(Board* board, Space* position, Player* player){
+    int cells = board->getRows() * board->getCols();
+    if ((int)visited.size() != cells){
+        visited.assign(cells, 0);
+    }
+
+    int here = board->getIndex(position);
+    if (here < 0){
+        random_moves++;
+        return RandomPolicy::choose_move(board, position, player);
+    }
+    visited[here] = 1;
+    bool to_vault = player->keys() >= 4;
+
+    const BoardDistances* distances = to_vault ? board->getDistances() : nullptr;
+    size_t vault = board->getLayout().find('!');
+    if (distances && vault != string::npos){
+        const std::vector<uint16_t>& moves = distances->towards(vault);
+        for (int dir = 0; moves[here] != DistanceMatrix::UNREACHABLE && dir < NUM_DIRECTIONS; dir++){
+            Space* to = position->getNeighbour(dir);
+            if (!to || to->getType() == MOUNTAIN){
+                continue;
+            }
+            if (to->getType() == TELEPORT){
+                to = to->get_ot();
+            }
+            int cell = board->getIndex(to);
+            if (cell >= 0 && moves[cell] + 1 == moves[here]){
+                return DIRECTIONS[dir].key;
+            }
+        }
+        random_moves++;
+        return RandomPolicy::choose_move(board, position, player);
+    }
+
+    first_step.assign(cells, -1);
+    first_step[here] = NUM_DIRECTIONS;
+    queue.assign(1, here);
+
+    for (size_t next = 0; next < queue.size(); next++){
+        Space* from = board->findCell(queue[next]);
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+            Space* to = from->getNeighbour(dir);
+            if (!to || to->getType() == MOUNTAIN){
+                continue;
+            }
+            bool unbuilt = to->getType() == UNBUILT;
+            if (to->getType() == TELEPORT){
+                to = to->get_ot();
+            }
+
+            int cell = board->getIndex(to);
+            if (cell < 0 || first_step[cell] >= 0){
+                continue;
+            }
+            first_step[cell] = (next == 0) ? dir : first_step[queue[next]];
+
+            bool target = to_vault ? (to->getSprite() == '!') : (!visited[cell] && to->getSprite() == '.');
+            if (target){
+                return DIRECTIONS[first_step[cell]].key;
+            }
+            if (!unbuilt){
+                queue.push_back(cell);
+            }
+        }
+    }
+
+    random_moves++;
+    return RandomPolicy::choose_move(board, position, player);
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Policy class. A Policy makes the decisions that a person
+** at the keyboard would otherwise make (which way to move, how much to wager in battle), allowing games
+** of Treasure Quest to be played without any terminal input or output.
+******************************************************************************************************************************************************/
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+#include <random>
+#include <vector>
+
+class Board;
+class Space;
+class Player;
+
+class Policy
+{
+    public:
+        //Returns one of the default move characters ('1'-'4', '6'-'9'). See Space::move_player().
+            virtual char choose_move(Board*, Space*, Player*) = 0;
+
+        //Returns a wager in the range [1, enemy_strength]. Called by Enemy::interact().
+        //Returning DEFER leaves the battle waiting until the wager is passed to Space::resolve_wager().
+            virtual int choose_wager(int enemy_strength, Player*) = 0;
+            static const int DEFER = 0;
+
+        virtual ~Policy(){};
+};
+
+//Moves in a random direction each turn and wagers a random amount in battle.
+class RandomPolicy : public Policy
+{
+    private:
+        std::default_random_engine rd;
+
+    public:
+        RandomPolicy();
+        RandomPolicy(unsigned seed);
+        virtual char choose_move(Board*, Space*, Player*);
+        virtual int  choose_wager(int enemy_strength, Player*);
+};
+
+//Moves in a random direction each turn, like RandomPolicy, but wagers whatever WagerTable.hpp gives the best chance of
+//winning the game with.
+class WagerPolicy : public RandomPolicy
+{
+    public:
+        WagerPolicy() : RandomPolicy(){};
+        WagerPolicy(unsigned seed) : RandomPolicy(seed){};
+        virtual int  choose_wager(int enemy_strength, Player*);
+};
+
+//Walks the shortest way to the nearest cell it hasn't visited that could hide an enemy ('.'), and to the vault once
+//it has 4 keys. Wagers like WagerPolicy. Falls back on a random move when nothing it wants is reachable.
+//It remembers the cells it has visited, so use a new GreedyPolicy, or call new_game(), for each game.
+class GreedyPolicy : public WagerPolicy
+{
+    private:
+        std::vector<char> visited;      //By cell index, see Board::getIndex()
+        std::vector<int>  first_step;   //Breadth-first search scratch space: the direction that leads to each cell
+        std::vector<int>  queue;
+        int random_moves;               //Moves this game that fell back on RandomPolicy
+
+    public:
+        GreedyPolicy() : WagerPolicy(){random_moves = 0;};
+        GreedyPolicy(unsigned seed) : WagerPolicy(seed){random_moves = 0;};
+        virtual char choose_move(Board*, Space*, Player*);
+
+        void new_game(){visited.clear(); random_moves = 0;};
+        int  getRandomMoves(){return random_moves;};  //0 while the moves depend on the board alone
+};
+
+//Moves like GreedyPolicy but never stakes more than a third of its strength on a battle, keeping strength in hand at
+//the risk of losing battles the table's wager would have won.
+class CautiousPolicy : public GreedyPolicy
+{
+    public:
+        static const int STAKE_DIVISOR = 3;     //The wager is at most strength / STAKE_DIVISOR, and at least 1
+
+        CautiousPolicy() : GreedyPolicy(){};
+        CautiousPolicy(unsigned seed) : GreedyPolicy(seed){};
+        virtual int  choose_wager(int enemy_strength, Player*);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Race class.
+******************************************************************************************************************************************************/
+#include "Race.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+const int BATTLE_STREAM = 0, MOVE_STREAM = 1;       //Which of a player's engines a seed is for
+
+/*****************************************************************************************************************************************************
+** unsigned racer_seed(unsigned seed, int index, int stream)
+** Mixes the race's seed, the player's index and which of its engines it is for through a seed_seq, so no two share a
+** seed and nearby seeds don't give related engines.
+******************************************************************************************************************************************************/
+static unsigned racer_seed(unsigned seed, int index, int stream){
+    std::seed_seq sequence{uint32_t(seed), uint32_t(index), uint32_t(stream)};
+    uint32_t result;
+    sequence.generate(&result, &result + 1);
+    return result;
+}
+
+/*****************************************************************************************************************************************************
+** Race constructor
+** Every player starts on the board's start, which already counts one of them.
+******************************************************************************************************************************************************/
+Race::Race(Board& board, int players, unsigned seed, int strength) : board(board), winner(-1){
+    if (board.isLazy()){
+        throw string("ERROR: A race needs a board that is built in full\n");
+    }
+    if (players < 1 || players > MAX_PLAYERS){
+        throw string("ERROR: A race needs between 1 and 65535 players\n");
+    }
+
+    Space* start = board.getPlayerStart();
+    for (int index = 0; index < players; index++){
+        racers.emplace_back(racer_seed(seed, index, BATTLE_STREAM), racer_seed(seed, index, MOVE_STREAM), strength);
+        racers.back().position = start;
+        if (index > 0){
+            start->arrive();
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** play(int first, int last, long max_turns)
+** Plays players [first, last) one move each per turn, until they're all out of the race or someone has won.
+******************************************************************************************************************************************************/
+void Race::play(int first, int last, long max_turns){
+    for (long turn = 0; turn < max_turns; turn++){
+        if (winner.load(std::memory_order_relaxed) >= 0){
+            return;
+        }
+
+        bool moved = false;
+        for (int index = first; index < last; index++){
+            Racer& racer = racers[index];
+            if (!racer.player.status() || racer.player.won_game()){
+                continue;
+            }
+
+            char move = racer.policy.choose_move(&board, racer.position, &racer.player);
+            racer.position = racer.position->move_player(move, &racer.player);
+            racer.moves++;
+            moved = true;
+
+            if (racer.player.won_game()){
+                int nobody = -1;
+                winner.compare_exchange_strong(nobody, index);
+            }
+        }
+
+        if (!moved){
+            return;
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** run(int threads, long max_turns)
+******************************************************************************************************************************************************/
+Race::Result Race::run(int threads, long max_turns){
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        int players = racers.size();
+        for (int first = 0; first < players; first += SLICE){
+            int last = (first + SLICE < players) ? first + SLICE : players;
+            pool.submit([this, first, last, max_turns]{
+                play(first, last, max_turns);
+            });
+        }
+        pool.wait();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    Result result = {winner.load(), 0, 0, 0, elapsed.count()};
+    for (Racer& racer : racers){
+        result.moves += racer.moves;
+        result.keys += racer.player.keys();
+        result.exhausted += !racer.player.status();
+    }
+    return result;
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Race class. A Race puts many headless players on one shared board
+** and lets them race for the keys at the same time, spread across a work-stealing thread pool. Every enemy can be
+** fought once between all of them, so with more players than enemies most never get a key. The race ends when a
+** player reaches the vault with four keys, when every player has run out of strength points, or after "max_turns"
+** moves each.
+
+** There is no lock and no barrier between turns. Each task plays a slice of the players, one move each in turn,
+** while the other slices move at the same time. Players only ever change two things on the board: how many players
+** are on each space, which is counted atomically, and whether an enemy has been fought, which the first player to
+** arrive claims with an atomic exchange (see Enemy::interact()). Everything else a player touches is its own.
+******************************************************************************************************************************************************/
+#ifndef RACE_HPP
+#define RACE_HPP
+
+#include <atomic>
+#include <deque>
+
+#include "Board.hpp"
+#include "Policy.hpp"
+
+class Race
+{
+    public:
+        static const int SLICE = 16;                //Players each task plays
+        static const int MAX_PLAYERS = 65535;       //Most players a space can count
+
+        struct Result
+        {
+            int    winner;                          //Index of the player who won, -1 if nobody did
+            long   moves;                           //Moves made by every player together
+            int    keys;                            //Keys won by every player together
+            int    exhausted;                       //Players who ran out of strength points
+            double seconds;
+        };
+
+    private:
+        //A player with its own engine and policy, so nothing it decides is shared. The engine rolls its battles and
+        //the policy chooses its moves, each from its own seed, so the two aren't correlated.
+            struct Racer
+            {
+                std::default_random_engine rd;
+                RandomPolicy policy;
+                Player player;
+                Space* position;
+                long moves;
+
+                Racer(unsigned battle_seed, unsigned move_seed, int strength) :
+                    rd(battle_seed), policy(move_seed), player(strength, &policy, &rd), position(nullptr), moves(0){};
+            };
+
+        Board& board;
+        std::deque<Racer> racers;                   //A deque, so each Racer stays where its Player points to it
+        std::atomic<int> winner;
+
+        Race(const Race&);
+        Race& operator=(const Race&);
+
+        void play(int first, int last, long max_turns);
+
+    public:
+        //Puts "players" players on the start of "board", each seeded from "seed" and its index. Throws a string if
+        //the board is built lazily or there are more than MAX_PLAYERS players.
+            Race(Board& board, int players, unsigned seed, int strength = 30);
+
+        //Runs the race on "threads" threads (0 for one per hardware thread). Call once.
+            Result run(int threads, long max_turns);
+};
+
+#endif
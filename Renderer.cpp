@@ -0,0 +1,157 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Renderer class.
+******************************************************************************************************************************************************/
+#include "Renderer.hpp"
+#include "Board.hpp"
+#include "Metrics.hpp"
+
+#include <cerrno>
+#include <unistd.h>
+
+/*****************************************************************************************************************************************************
+** Renderer constructor
+** fd - The file descriptor frames are written to (standard output by default).
+** redraw - True to keep the board in place and redraw only the cells that change.
+
+** Anything written to cout is flushed before the next write to the Renderer's stream, so the two never appear out
+** of order.
+******************************************************************************************************************************************************/
+Renderer::Renderer(int fd, bool redraw) : fd(fd), redraw(redraw), buffer(this), screen(&buffer),
+    shown_rows(0), shown_cols(0), shown_strength(0), shown_keys(0), shown_valid(false){
+
+    frame.reserve(4096);
+    messages.reserve(4096);
+    screen.tie(&cout);
+}
+
+/*****************************************************************************************************************************************************
+** FrameBuffer::overflow(int_type character) and FrameBuffer::xsputn(const char* text, std::streamsize count)
+** The stream has no buffer of its own, so every write lands here and goes straight into the frame.
+******************************************************************************************************************************************************/
+Renderer::FrameBuffer::int_type Renderer::FrameBuffer::overflow(int_type character){
+    if (!traits_type::eq_int_type(character, traits_type::eof())){
+        owner->frame += traits_type::to_char_type(character);
+        owner->messages += traits_type::to_char_type(character);
+    }
+    return traits_type::not_eof(character);
+}
+
+std::streamsize Renderer::FrameBuffer::xsputn(const char* text, std::streamsize count){
+    owner->frame.append(text, count);
+    owner->messages.append(text, count);
+    return count;
+}
+
+/*****************************************************************************************************************************************************
+** FrameBuffer::sync()
+** Called when the stream is flushed. Output written straight to cout (e.g. the error messages in menu.cpp) is
+** flushed along with the frame.
+******************************************************************************************************************************************************/
+int Renderer::FrameBuffer::sync(){
+    owner->present();
+    cout.flush();
+    return 0;
+}
+
+/*****************************************************************************************************************************************************
+** draw_turn(Board& board, Player& player)
+******************************************************************************************************************************************************/
+void Renderer::draw_turn(Board& board, Player& player){
+    Metrics::Timer timer(Metrics::RENDER);
+    int rows = board.getRows(), cols = board.getCols();
+    board.getSprites(sprites);
+
+    if (!redraw){
+        frame += "---------------------------------------------------------------------------------------\n";
+        draw_header(player);
+        frame += "\n";
+        for (int index = 0; index < rows * cols; index++){
+            frame += sprites[index];
+            frame += ' ';
+            if (index % cols == cols - 1){
+                frame += '\n';
+            }
+        }
+        frame += '\n';
+        messages.clear();
+        return;
+    }
+
+    //The messages are redrawn below the board, so any copy of them still waiting in the frame is dropped
+    frame.clear();
+
+    if (!shown_valid || rows != shown_rows || cols != shown_cols){
+        frame += "\x1b[H\x1b[2J";
+        shown.assign(rows * cols, '\0');
+        shown_rows = rows;
+        shown_cols = cols;
+        shown_strength = shown_keys = -1;
+        shown_valid = true;
+    }
+
+    if (player.strength() != shown_strength || player.keys() != shown_keys){
+        move_cursor(1, 1);
+        draw_header(player);
+        shown_strength = player.strength();
+        shown_keys = player.keys();
+    }
+
+    //Cell (row, col) of the display is drawn at terminal row 4 + row, column 1 + 2 * col
+    for (int index = 0; index < rows * cols; index++){
+        if (sprites[index] != shown[index]){
+            move_cursor(4 + index / cols, 1 + 2 * (index % cols));
+            frame += sprites[index];
+            shown[index] = sprites[index];
+        }
+    }
+
+    move_cursor(rows + 5, 1);
+    frame += "\x1b[J";
+    frame += messages;
+    messages.clear();
+}
+
+/*****************************************************************************************************************************************************
+** draw_header(Player& player)
+** Each line is cleared to its end, so a shorter number doesn't leave digits of the old one behind in redraw mode.
+******************************************************************************************************************************************************/
+void Renderer::draw_header(Player& player){
+    frame += "Player strength: ";
+    frame += std::to_string(player.strength());
+    frame += redraw ? "\x1b[K\n" : "\n";
+    frame += "Player Keys: ";
+    frame += std::to_string(player.keys());
+    frame += redraw ? "\x1b[K\n" : "\n";
+}
+
+/*****************************************************************************************************************************************************
+** move_cursor(int row, int col)
+** Rows and columns are numbered from 1, as in the ANSI cursor position sequence.
+******************************************************************************************************************************************************/
+void Renderer::move_cursor(int row, int col){
+    frame += "\x1b[";
+    frame += std::to_string(row);
+    frame += ';';
+    frame += std::to_string(col);
+    frame += 'H';
+}
+
+/*****************************************************************************************************************************************************
+** present()
+******************************************************************************************************************************************************/
+void Renderer::present(){
+    size_t written = 0;
+    while (written < frame.size()){
+        ssize_t count = write(fd, frame.data() + written, frame.size() - written);
+        if (count < 0){
+            if (errno == EINTR){
+                continue;
+            }
+            break;
+        }
+        written += count;
+    }
+    frame.clear();
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Renderer class. Everything the game shows during a turn (the status
+** header, the board, the dialogue from the spaces and the prompts) is written to the Renderer's stream, which
+** collects it in one buffer instead of sending it to the terminal piece by piece. The buffer goes out in a single
+** write() when the stream is flushed, which happens just before the game reads input (see main()), so each turn
+** costs one system call however much text it produces.
+
+** In redraw mode the board stays in place at the top of the terminal. Each frame moves the cursor to the cells that
+** changed since the last one and rewrites only those, then clears and rewrites the message area below the board.
+******************************************************************************************************************************************************/
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include <string>
+#include <ostream>
+#include <streambuf>
+
+class Board;
+class Player;
+
+class Renderer
+{
+    private:
+        //Appends everything written to the stream to the frame, and to the messages of the current turn.
+            class FrameBuffer : public std::streambuf
+            {
+                private:
+                    Renderer* owner;
+
+                protected:
+                    virtual int_type overflow(int_type character);
+                    virtual std::streamsize xsputn(const char* text, std::streamsize count);
+                    virtual int sync();
+
+                public:
+                    FrameBuffer(Renderer* owner) : owner(owner){};
+            };
+
+        int fd;                         //Where frames are written
+        bool redraw;                    //True to update the board in place with ANSI cursor moves
+        FrameBuffer buffer;
+        std::ostream screen;
+
+        std::string frame;              //Text waiting to be written. Reused, so its memory is allocated once.
+        std::string messages;           //Everything written since the last frame was drawn
+
+        //What the terminal currently shows, used in redraw mode to find what changed
+            std::string shown, sprites;
+            int shown_rows, shown_cols, shown_strength, shown_keys;
+            bool shown_valid;
+
+        void draw_header(Player& player);
+        void move_cursor(int row, int col);
+
+    public:
+        Renderer(int fd = 1, bool redraw = false);
+
+        //The stream to write game output to. Flushing it writes the frame.
+            std::ostream& stream(){return screen;};
+
+        //Adds the status header and board for a new turn to the frame. In redraw mode, also redraws the messages
+        //written during the last turn below the board.
+            void draw_turn(Board& board, Player& player);
+
+        //Forgets what the terminal shows and the messages of the last turn, so the next frame in redraw mode is
+        //drawn in full. Call when starting a new game or after anything else has written to the terminal.
+            void invalidate(){shown_valid = false; messages.clear();};
+
+        //Writes the frame and empties it.
+            void present();
+};
+
+#endif
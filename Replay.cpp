@@ -0,0 +1,188 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for game replays.
+******************************************************************************************************************************************************/
+#include "Replay.hpp"
+
+#include "BitBoard.hpp"
+
+const char MAGIC[4] = {'T', 'Q', 'R', 'P'};
+const uint32_t VERSION = 1;
+const size_t FIXED_RECORD_SIZE = 22;        //Every field before the packed moves and wagers
+
+/*****************************************************************************************************************************************************
+** Helpers for reading and writing little-endian integers
+******************************************************************************************************************************************************/
+static void put_uint(string& bytes, uint64_t value, int width){
+    for (int index = 0; index < width; index++){
+        bytes += char(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+static uint64_t get_uint(const string& bytes, size_t position, int width){
+    uint64_t value = 0;
+    for (int index = width - 1; index >= 0; index--){
+        value = (value << 8) | (unsigned char)bytes[position + index];
+    }
+    return value;
+}
+
+/*****************************************************************************************************************************************************
+** RecordingPolicy
+******************************************************************************************************************************************************/
+char RecordingPolicy::choose_move(Board* board, Space* space, Player* player){
+    char move = policy->choose_move(board, space, player);
+    record->moves += move;
+    return move;
+}
+
+int RecordingPolicy::choose_wager(int enemy_strength, Player* player){
+    int wager = policy->choose_wager(enemy_strength, player);
+    record->wagers.push_back(wager);
+    return wager;
+}
+
+/*****************************************************************************************************************************************************
+** ReplayPolicy
+** Only asked for as many moves as were recorded (see replay_game()). If a rule change leads to more battles than
+** were recorded, the extra wagers are 1.
+******************************************************************************************************************************************************/
+char ReplayPolicy::choose_move(Board*, Space*, Player*){
+    return record->moves[next_move++];
+}
+
+int ReplayPolicy::choose_wager(int, Player*){
+    return (next_wager < record->wagers.size()) ? record->wagers[next_wager++] : 1;
+}
+
+/*****************************************************************************************************************************************************
+** ReplayWriter(const string& filename)
+******************************************************************************************************************************************************/
+ReplayWriter::ReplayWriter(const string& filename){
+    file.open(filename, std::ios::binary | std::ios::trunc);
+
+    string header(MAGIC, 4);
+    put_uint(header, VERSION, 4);
+    file.write(header.data(), header.size());
+}
+
+/*****************************************************************************************************************************************************
+** write(const GameRecord& record)
+******************************************************************************************************************************************************/
+void ReplayWriter::write(const GameRecord& record){
+    string bytes;
+    put_uint(bytes, record.seed, 8);
+    put_uint(bytes, record.map_id, 4);
+    put_uint(bytes, record.starting_strength, 2);
+    put_uint(bytes, record.won, 1);
+    put_uint(bytes, record.keys, 1);
+    put_uint(bytes, record.strength, 2);
+    put_uint(bytes, record.moves.size(), 2);
+    put_uint(bytes, record.wagers.size(), 2);
+
+    //Pack two 4-bit values per byte
+    for (size_t index = 0; index < record.moves.size(); index += 2){
+        int low = BitBoard::direction(record.moves[index]);
+        int high = (index + 1 < record.moves.size()) ? BitBoard::direction(record.moves[index + 1]) : 0;
+        bytes += char(low | (high << 4));
+    }
+    for (size_t index = 0; index < record.wagers.size(); index += 2){
+        int low = record.wagers[index] - 1;
+        int high = (index + 1 < record.wagers.size()) ? record.wagers[index + 1] - 1 : 0;
+        bytes += char(low | (high << 4));
+    }
+
+    file.write(bytes.data(), bytes.size());
+}
+
+/*****************************************************************************************************************************************************
+** ReplayReader(const string& filename)
+******************************************************************************************************************************************************/
+ReplayReader::ReplayReader(const string& filename){
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file){
+        throw string("ERROR: Could not open " + filename + "\n");
+    }
+
+    buffer.resize(file.tellg());
+    file.seekg(0);
+    file.read(&buffer[0], buffer.size());
+
+    if (buffer.size() < 8 || buffer.compare(0, 4, MAGIC, 4) != 0 || get_uint(buffer, 4, 4) != VERSION){
+        throw string("ERROR: " + filename + " is not a replay file\n");
+    }
+    position = 8;
+}
+
+/*****************************************************************************************************************************************************
+** bool next(GameRecord& record)
+******************************************************************************************************************************************************/
+bool ReplayReader::next(GameRecord& record){
+    if (position + FIXED_RECORD_SIZE > buffer.size()){
+        return false;
+    }
+
+    record.seed              = get_uint(buffer, position, 8);
+    record.map_id            = get_uint(buffer, position + 8, 4);
+    record.starting_strength = get_uint(buffer, position + 12, 2);
+    record.won               = get_uint(buffer, position + 14, 1);
+    record.keys              = get_uint(buffer, position + 15, 1);
+    record.strength          = get_uint(buffer, position + 16, 2);
+    size_t num_moves         = get_uint(buffer, position + 18, 2);
+    size_t num_wagers        = get_uint(buffer, position + 20, 2);
+    position += FIXED_RECORD_SIZE;
+
+    size_t move_bytes = (num_moves + 1) / 2, wager_bytes = (num_wagers + 1) / 2;
+    if (position + move_bytes + wager_bytes > buffer.size()){
+        return false;
+    }
+
+    record.moves.resize(num_moves);
+    for (size_t index = 0; index < num_moves; index++){
+        unsigned char packed = buffer[position + index / 2];
+        record.moves[index] = DIRECTIONS[(index % 2) ? (packed >> 4) : (packed & 0x0F)].key;
+    }
+    position += move_bytes;
+
+    record.wagers.resize(num_wagers);
+    for (size_t index = 0; index < num_wagers; index++){
+        unsigned char packed = buffer[position + index / 2];
+        record.wagers[index] = ((index % 2) ? (packed >> 4) : (packed & 0x0F)) + 1;
+    }
+    position += wager_bytes;
+
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** GameRecord record_game(Policy* policy, Board* game_board, const std::vector<MapTemplate>& maps,
+**                        uint64_t seed, int starting_strength)
+******************************************************************************************************************************************************/
+GameRecord record_game(Policy* policy, Board* game_board, const std::vector<MapTemplate>& maps,
+                       uint64_t seed, int starting_strength){
+    GameRecord record;
+    record.seed = seed;
+    record.starting_strength = starting_strength;
+
+    RecordingPolicy recorder(policy, &record);
+    std::default_random_engine rd(seed);
+    GameResult result = play_headless(&recorder, game_board, maps, rd, starting_strength);
+
+    record.map_id = result.map_id;
+    record.won = result.won;
+    record.keys = result.keys;
+    record.strength = result.strength;
+    return record;
+}
+
+/*****************************************************************************************************************************************************
+** GameResult replay_game(const GameRecord& record, Board* game_board, const std::vector<MapTemplate>& maps)
+** Seeds a fresh engine exactly as record_game() did, so the board and every battle roll come out the same.
+******************************************************************************************************************************************************/
+GameResult replay_game(const GameRecord& record, Board* game_board, const std::vector<MapTemplate>& maps){
+    ReplayPolicy replayer(&record);
+    std::default_random_engine rd(record.seed);
+    return play_headless(&replayer, game_board, maps, rd, record.starting_strength, record.moves.size());
+}
@@ -0,0 +1,94 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for game replays. A headless game is fully determined by the seed of its
+** random number engine (which chooses the template, places the pieces and rolls every battle) together with the
+** moves and wagers its policy chose. A GameRecord holds exactly that, plus the outcome, so a recorded game can be
+** re-executed later and checked against the result it had when it was recorded.
+
+** Replay file layout (integers little-endian): "TQRP", uint32 version, then one record after another:
+    - uint64 seed, uint32 map id, uint16 starting strength
+    - uint8 won, uint8 keys, uint16 strength remaining           (outcome when recorded)
+    - uint16 number of moves, uint16 number of wagers
+    - moves, two per byte: direction 0-7 in the order "12346789", first move in the low four bits
+    - wagers, two per byte: wager - 1, first wager in the low four bits
+******************************************************************************************************************************************************/
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "Policy.hpp"
+#include "Simulation.hpp"
+
+struct GameRecord
+{
+    uint64_t seed;
+    uint32_t map_id;
+    int      starting_strength;
+    string   moves;                 //Move characters, '1'-'4' and '6'-'9'
+    std::vector<int> wagers;        //Battle wagers, each in [1, 10]
+
+    bool     won;                   //Outcome when the game was recorded
+    int      keys, strength;
+};
+
+//Passes every decision of another policy through unchanged, adding it to a GameRecord.
+class RecordingPolicy : public Policy
+{
+    private:
+        Policy* policy;
+        GameRecord* record;
+
+    public:
+        RecordingPolicy(Policy* policy, GameRecord* record) : policy(policy), record(record){};
+        virtual char choose_move(Board*, Space*, Player*);
+        virtual int  choose_wager(int enemy_strength, Player*);
+};
+
+//Repeats the moves and wagers of a GameRecord in order.
+class ReplayPolicy : public Policy
+{
+    private:
+        const GameRecord* record;
+        size_t next_move, next_wager;
+
+    public:
+        ReplayPolicy(const GameRecord* record) : record(record), next_move(0), next_wager(0){};
+        virtual char choose_move(Board*, Space*, Player*);
+        virtual int  choose_wager(int enemy_strength, Player*);
+};
+
+class ReplayWriter
+{
+    private:
+        std::ofstream file;
+
+    public:
+        explicit ReplayWriter(const string& filename);
+        bool good(){return file.good();};
+        void write(const GameRecord& record);
+};
+
+//Reads a whole replay file into memory with a single read, then decodes records from the buffer.
+class ReplayReader
+{
+    private:
+        string buffer;
+        size_t position;
+
+    public:
+        explicit ReplayReader(const string& filename);     //Throws a string if the file isn't a replay file
+        bool next(GameRecord& record);                      //Returns false once every record has been read
+};
+
+//Plays "policy" on a board rebuilt in place from "seed", recording the game.
+GameRecord record_game(Policy* policy, Board* game_board, const std::vector<MapTemplate>& maps,
+                       uint64_t seed, int starting_strength = 30);
+
+//Re-executes a recorded game on "game_board". Compare the result with the record to detect rule changes.
+GameResult replay_game(const GameRecord& record, Board* game_board, const std::vector<MapTemplate>& maps);
+
+#endif
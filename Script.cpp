@@ -0,0 +1,154 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for scripted play.
+******************************************************************************************************************************************************/
+#include "Script.hpp"
+#include "Grid.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+
+inline bool is_space(char character){
+    return character == ' ' || character == '\n' || character == '\r' || character == '\t';
+}
+
+/*****************************************************************************************************************************************************
+** Script constructors and destructor
+******************************************************************************************************************************************************/
+Script::Script(int fd) : fd(fd), owns_fd(false), at_end(false), position(0), commands(0){
+}
+
+Script::Script(const string& filename) : fd(0), owns_fd(false), at_end(false), position(0), commands(0){
+    if (filename != "-"){
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0){
+            throw string("ERROR: Could not open ") + filename + "\n";
+        }
+        owns_fd = true;
+    }
+}
+
+Script::~Script(){
+    if (owns_fd){
+        ::close(fd);
+    }
+}
+
+/*****************************************************************************************************************************************************
+** fill()
+** Drops what has been consumed, then appends up to BLOCK bytes. A pipe returns what is available, so commands are
+** handed out as soon as they arrive rather than when the writer closes it.
+******************************************************************************************************************************************************/
+bool Script::fill(){
+    if (at_end){
+        return false;
+    }
+
+    buffer.erase(0, position);
+    position = 0;
+
+    size_t used = buffer.size();
+    buffer.resize(used + BLOCK);
+    ssize_t result;
+    do {
+        result = ::read(fd, &buffer[used], BLOCK);
+    } while (result < 0 && errno == EINTR);
+
+    buffer.resize(used + (result > 0 ? result : 0));
+    if (result <= 0){
+        at_end = true;
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** next(std::string_view& command)
+** A command that reaches the end of the buffer may continue in the next block, so it is only handed out once the
+** whitespace after it, or the end of the stream, has been read.
+******************************************************************************************************************************************************/
+bool Script::next(std::string_view& command){
+    size_t end;
+    for (;;){
+        while (position < buffer.size() && is_space(buffer[position])){
+            position++;
+        }
+        end = position;
+        while (end < buffer.size() && !is_space(buffer[end])){
+            end++;
+        }
+
+        if (end < buffer.size()){
+            break;
+        }
+        if (!fill()){
+            if (end > position){
+                break;
+            }
+            return false;
+        }
+    }
+
+    command = std::string_view(buffer.data() + position, end - position);
+    position = end;
+    commands++;
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** parse_int(std::string_view command, int& value)
+******************************************************************************************************************************************************/
+bool Script::parse_int(std::string_view command, int& value){
+    const char* last = command.data() + command.size();
+    std::from_chars_result result = std::from_chars(command.data(), last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+/*****************************************************************************************************************************************************
+** ScriptPolicy::choose_move(Board*, Space*, Player*)
+******************************************************************************************************************************************************/
+char ScriptPolicy::choose_move(Board*, Space*, Player*){
+    std::string_view command;
+    while (script.next(command)){
+        if (command.size() == 1 && move_direction(command[0]) >= 0){
+            return command[0];
+        }
+        out << "Invalid move. Enter: ";
+    }
+    ended = true;
+    return 0;
+}
+
+/*****************************************************************************************************************************************************
+** ScriptPolicy::choose_wager(int enemy_strength, Player*)
+******************************************************************************************************************************************************/
+int ScriptPolicy::choose_wager(int enemy_strength, Player*){
+    std::string_view command;
+    int wager;
+    while (script.next(command)){
+        if (Script::parse_int(command, wager) && wager >= 1 && wager <= enemy_strength){
+            return wager;
+        }
+        out << "Response must be an integer between 1 and " << enemy_strength << " inclusive\nEnter: ";
+    }
+    ended = true;
+    return 1;
+}
+
+/*****************************************************************************************************************************************************
+** ScriptPolicy::choose_option(const string& choices, const string& error_mes)
+******************************************************************************************************************************************************/
+char ScriptPolicy::choose_option(const string& choices, const string& error_mes){
+    std::string_view command;
+    while (script.next(command)){
+        if (command.size() == 1 && choices.find(command[0]) != string::npos){
+            return command[0];
+        }
+        out << error_mes;
+    }
+    ended = true;
+    return 0;
+}
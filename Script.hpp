@@ -0,0 +1,76 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for scripted play. A Script reads a stream of commands (a file, or a pipe
+** from another program) in large blocks and splits it into commands without copying them. Commands are what a
+** player would type at each prompt: a move key, a wager or 'y'/'n'. Any whitespace separates them, so a script can
+** hold one per line like a terminal session, or many to a line.
+
+** A ScriptPolicy plays a game from a Script. A command that isn't valid at its prompt gets the same error message
+** as at the terminal and the next command is tried, so a script recorded from a terminal session plays the same.
+******************************************************************************************************************************************************/
+#ifndef SCRIPT_HPP
+#define SCRIPT_HPP
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "Policy.hpp"
+
+using std::string;
+
+class Script
+{
+    private:
+        int fd;
+        bool owns_fd, at_end;
+        string buffer;                      //Bytes read that haven't all been consumed
+        size_t position;                    //Where the next command starts looking in "buffer"
+        long commands;
+
+        Script(const Script&);              //Not copyable: owns the descriptor
+        Script& operator=(const Script&);
+
+        bool fill();                        //Reads another block. Returns false at the end of the stream.
+
+    public:
+        static const size_t BLOCK = 1 << 16;
+
+        explicit Script(int fd = 0);                //Reads from an open descriptor, standard input by default
+        explicit Script(const string& filename);    //"-" for standard input. Throws a string if the file can't be opened.
+        ~Script();
+
+        //Sets "command" to the next command. It points into the Script's buffer and is only valid until the next call.
+        //Returns false at the end of the stream.
+            bool next(std::string_view& command);
+
+        long getCommands(){return commands;};       //Commands read so far
+        bool finished(){return at_end && position >= buffer.size();};
+
+        //Converts a whole command to an integer. Returns false if it isn't one.
+            static bool parse_int(std::string_view command, int& value);
+};
+
+//Plays moves and wagers from a Script with the default controls. At the end of the script, choose_move() returns 0
+//and choose_wager() returns 1, and finished() is true.
+class ScriptPolicy : public Policy
+{
+    private:
+        Script& script;
+        std::ostream& out;                  //Where error messages for invalid commands are written
+        bool ended;
+
+    public:
+        ScriptPolicy(Script& script, std::ostream& out) : script(script), out(out), ended(false){};
+
+        virtual char choose_move(Board*, Space*, Player*);
+        virtual int  choose_wager(int enemy_strength, Player*);
+
+        //Returns the next command that is one of "choices", 0 at the end of the script.
+            char choose_option(const string& choices, const string& error_mes);
+
+        bool finished(){return ended;};
+};
+
+#endif
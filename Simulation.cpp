@@ -0,0 +1,78 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the headless game runner.
+******************************************************************************************************************************************************/
+#include "Simulation.hpp"
+#include "Metrics.hpp"
+
+/*****************************************************************************************************************************************************
+** GameResult play_turns(Policy* policy, Board* game_board, Player* player, int max_moves)
+** Mirrors the turn loop in main(): the policy picks a move, the current space moves the player, and the game
+** ends when the player runs out of strength or wins. Battles get their wagers from the policy through the Player.
+******************************************************************************************************************************************************/
+static GameResult play_turns(Policy* policy, Board* game_board, Player* player, int max_moves){
+    Space* current_space = game_board->getPlayerStart();
+
+    int moves = 0;
+    while (player->status() && !player->won_game() && moves < max_moves){
+        char move = policy->choose_move(game_board, current_space, player);
+        current_space = current_space->move_player(move, player);
+        moves++;
+    }
+
+    Metrics::count(player->won_game() ? Metrics::GAMES_WON : Metrics::GAMES_LOST);
+
+    GameResult result;
+    result.won = player->won_game();
+    result.strength = player->strength();
+    result.keys = player->keys();
+    result.moves = moves;
+    result.map_id = game_board->getMapId();
+    return result;
+}
+
+/*****************************************************************************************************************************************************
+** GameResult play_headless(Policy* policy, int starting_strength, int max_moves)
+******************************************************************************************************************************************************/
+GameResult play_headless(Policy* policy, int starting_strength, int max_moves){
+    Player player(starting_strength, policy);
+    Board game_board;
+
+    return play_turns(policy, &game_board, &player, max_moves);
+}
+
+/*****************************************************************************************************************************************************
+** GameResult play_headless(Policy* policy, const std::vector<MapTemplate>& maps, std::default_random_engine& rd,
+**                          int starting_strength, int max_moves)
+******************************************************************************************************************************************************/
+GameResult play_headless(Policy* policy, const std::vector<MapTemplate>& maps, std::default_random_engine& rd,
+                         int starting_strength, int max_moves){
+    Player player(starting_strength, policy, &rd);
+    Board game_board(maps, rd);
+
+    return play_turns(policy, &game_board, &player, max_moves);
+}
+
+/*****************************************************************************************************************************************************
+** GameResult play_headless(Policy* policy, Board* game_board, const std::vector<MapTemplate>& maps,
+**                          std::default_random_engine& rd, int starting_strength, int max_moves)
+******************************************************************************************************************************************************/
+GameResult play_headless(Policy* policy, Board* game_board, const std::vector<MapTemplate>& maps,
+                         std::default_random_engine& rd, int starting_strength, int max_moves){
+    Player player(starting_strength, policy, &rd);
+    game_board->reset(maps, rd);
+
+    return play_turns(policy, game_board, &player, max_moves);
+}
+
+/*****************************************************************************************************************************************************
+** GameResult play_headless(Policy* policy, Board* game_board, std::default_random_engine& rd, int starting_strength,
+**                          int max_moves)
+******************************************************************************************************************************************************/
+GameResult play_headless(Policy* policy, Board* game_board, std::default_random_engine& rd, int starting_strength,
+                         int max_moves){
+    Player player(starting_strength, policy, &rd);
+
+    return play_turns(policy, game_board, &player, max_moves);
+}
@@ -0,0 +1,40 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the headless game runner. It plays complete games of Treasure Quest
+** using the same Board, Space and Player code as the interactive game, but with a Policy making every decision
+** and no terminal input or output.
+******************************************************************************************************************************************************/
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include "Board.hpp"
+#include "Policy.hpp"
+
+//Outcome of a single headless game.
+struct GameResult
+{
+    bool won;           //True if the player reached the vault with 4 keys
+    int  strength;      //Strength points remaining at the end of the game
+    int  keys;          //Keys held at the end of the game
+    int  moves;         //Number of moves requested by the policy, including blocked ones
+    int  map_id;        //Template the board was built from
+};
+
+//Plays one game. "max_moves" caps games whose policy never finishes (e.g. one that keeps walking into a mountain).
+GameResult play_headless(Policy* policy, int starting_strength = 30, int max_moves = 1000);
+
+//Plays one game on a template from "maps", drawing the board layout and every battle roll from "rd".
+//Nothing is read from disk and no engine is seeded, so many of these can run at once on different threads.
+GameResult play_headless(Policy* policy, const std::vector<MapTemplate>& maps, std::default_random_engine& rd,
+                         int starting_strength = 30, int max_moves = 1000);
+
+//Same as above, but rebuilds "game_board" in place with Board::reset() instead of constructing a new board.
+GameResult play_headless(Policy* policy, Board* game_board, const std::vector<MapTemplate>& maps,
+                         std::default_random_engine& rd, int starting_strength = 30, int max_moves = 1000);
+
+//Plays "game_board" as it is, without building or resetting it. Only the battle rolls come from "rd".
+GameResult play_headless(Policy* policy, Board* game_board, std::default_random_engine& rd,
+                         int starting_strength = 30, int max_moves = 1000);
+
+#endif
@@ -0,0 +1,272 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Snapshot class.
+******************************************************************************************************************************************************/
+#include "Snapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char MAGIC[4] = {'T', 'Q', 'S', 'S'};
+
+static_assert(sizeof(Snapshot::Header) == 72, "Snapshot::Header must have no padding");
+
+/*****************************************************************************************************************************************************
+** encode(string& buffer, Board& board, Player& player, Space* position, std::default_random_engine& rd, int phase)
+** Only enemies and portals have state of their own, so only the cells the layout marks as one are looked at. On a
+** lazily built board, cells that haven't been built are left as the layout describes them.
+******************************************************************************************************************************************************/
+void Snapshot::encode(string& buffer, Board& board, Player& player, Space* position, std::default_random_engine& rd,
+                      int phase){
+    const string& layout = board.getLayout();
+    int cells = layout.length();
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.rows = board.getRows();
+    header.cols = board.getCols();
+    header.map_id = board.getMapId();
+    header.strength = player.strength();
+    header.keys = player.keys();
+    header.victory = player.won_game();
+    header.phase = phase;
+    header.position = board.getIndex(position);
+
+    if (position->awaiting_wager()){
+        header.battle_pending = 1;
+        header.enemy_strength = position->wager_limit();
+        header.enemy_attack = static_cast<Enemy*>(position)->attack();
+    }
+
+    std::ostringstream engine;
+    engine << rd;
+    if (engine.str().length() >= sizeof(header.engine)){
+        throw string("ERROR: The random engine's state does not fit in a snapshot\n");
+    }
+    std::memcpy(header.engine, engine.str().c_str(), engine.str().length());
+
+    buffer.assign(sizeof(header), '\0');
+    buffer.append(layout);
+    buffer.append(cells, '\0');
+    size_t states = sizeof(header) + cells;
+
+    for (int cell = 0; cell < cells; cell++){
+        if (layout[cell] != 'e' && layout[cell] != 'O'){
+            continue;
+        }
+        Space* space = board.findCell(cell);
+        if (!space){
+            continue;
+        }
+
+        if (space->getType() == ENEMY && static_cast<Enemy*>(space)->fought()){
+            buffer[states + cell] = FOUGHT;
+        }
+        else if (space->getType() == TELEPORT){
+            int32_t link[2] = {cell, board.getIndex(space->get_ot())};
+            buffer.append(reinterpret_cast<const char*>(link), sizeof(link));
+            header.portals++;
+        }
+    }
+
+    std::memcpy(&buffer[0], &header, sizeof(header));
+}
+
+/*****************************************************************************************************************************************************
+** Space* decode(const char* data, size_t length, Board& board, Player& player, std::default_random_engine& rd, int* phase,
+**               int phases)
+******************************************************************************************************************************************************/
+Space* Snapshot::decode(const char* data, size_t length, Board& board, Player& player, std::default_random_engine& rd,
+                        int* phase, int phases){
+    Header header;
+    if (length < sizeof(header)){
+        throw string("ERROR: Not a saved game\n");
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    int64_t cells = int64_t(header.rows) * header.cols;
+    if (std::memcmp(header.magic, MAGIC, 4) != 0 || header.version != VERSION || header.rows <= 0 || header.cols <= 0
+        || header.portals < 0 || header.position < 0 || header.position >= cells || header.phase >= phases
+        || header.strength < 0 || header.keys < 0 || header.keys > 4 || (header.victory && header.keys < 4)
+        || length != sizeof(header) + 2 * cells + 8 * (size_t)header.portals){
+        throw string("ERROR: Not a saved game\n");
+    }
+
+    const char* layout = data + sizeof(header);
+    const char* states = layout + cells;
+    const int32_t* links = reinterpret_cast<const int32_t*>(states + cells);
+
+    //Check everything before the board is touched, so a bad snapshot leaves the game as it was. The layout needs
+    //exactly one start, which load_layout() places the player on, and the player can't stand on a mountain.
+    int starts = 0;
+    std::vector<int64_t> portal_cells;
+    for (int64_t cell = 0; cell < cells; cell++){
+        if (!std::strchr("A.x!Oe", layout[cell]) || layout[cell] == '\0'){
+            throw string("ERROR: Not a saved game\n");
+        }
+        starts += (layout[cell] == 'x');
+        if (layout[cell] == 'O'){
+            portal_cells.push_back(cell);
+        }
+    }
+    if (starts != 1 || layout[header.position] == 'A' || portal_cells.size() % 2 != 0){
+        throw string("ERROR: Not a saved game\n");
+    }
+
+    //A pending battle must be one the enemy could have started
+    if (header.battle_pending && (layout[header.position] != 'e' || header.enemy_strength < 6
+                                  || header.enemy_strength > 10 || header.enemy_attack < 1
+                                  || header.enemy_attack > header.enemy_strength)){
+        throw string("ERROR: Not a saved game\n");
+    }
+
+    //The board always pairs portals in the order they appear in the layout, so each link must be between a portal
+    //and that partner, and both ends must be saved. A board built at once saves every portal; a lazily built one
+    //only those it has built, and builds the rest in their pairs later.
+    std::unordered_map<int32_t, int32_t> partners;
+    for (int32_t portal = 0; portal < header.portals; portal++){
+        int32_t cell, partner;
+        std::memcpy(&cell, links + 2 * portal, sizeof(cell));
+        std::memcpy(&partner, links + 2 * portal + 1, sizeof(partner));
+        if (cell < 0 || cell >= cells || partner < 0 || partner >= cells || layout[cell] != 'O'
+            || layout[partner] != 'O' || !partners.emplace(cell, partner).second){
+            throw string("ERROR: Not a saved game\n");
+        }
+        size_t order = std::lower_bound(portal_cells.begin(), portal_cells.end(), cell) - portal_cells.begin();
+        if (portal_cells[order ^ 1] != partner){
+            throw string("ERROR: Not a saved game\n");
+        }
+    }
+    for (const std::pair<const int32_t, int32_t>& link : partners){
+        if (!partners.count(link.second)){
+            throw string("ERROR: Not a saved game\n");
+        }
+    }
+    if (cells <= Board::LAZY_CELLS && partners.size() != portal_cells.size()){
+        throw string("ERROR: Not a saved game\n");
+    }
+
+    //The engine's state must end within its field and parse
+    std::default_random_engine restored;
+    if (strnlen(header.engine, sizeof(header.engine)) == sizeof(header.engine)){
+        throw string("ERROR: Not a saved game\n");
+    }
+    std::istringstream engine(header.engine);
+    if (!(engine >> restored)){
+        throw string("ERROR: Not a saved game\n");
+    }
+
+    board.load_layout(string(layout, cells), header.rows, header.cols, header.map_id);
+
+    for (int cell = 0; cell < cells; cell++){
+        if ((states[cell] & FOUGHT) && layout[cell] == 'e'){
+            static_cast<Enemy*>(board.getCell(cell))->restore(true, false, 0, 0);
+        }
+    }
+
+    for (int32_t portal = 0; portal < header.portals; portal++){
+        int32_t cell, partner;
+        std::memcpy(&cell, links + 2 * portal, sizeof(cell));
+        std::memcpy(&partner, links + 2 * portal + 1, sizeof(partner));
+        board.getCell(cell)->set_other_teleport(board.getCell(partner));
+    }
+
+    Space* position = board.getCell(header.position);
+    board.getPlayerStart()->set_occupied(false);
+    position->set_occupied(true);
+
+    if (header.battle_pending){
+        static_cast<Enemy*>(position)->restore(states[header.position] & FOUGHT, true, header.enemy_strength,
+                                               header.enemy_attack);
+    }
+
+    player.restore(header.strength, header.keys, header.victory);
+
+    rd = restored;
+
+    if (phase){
+        *phase = header.phase;
+    }
+    return position;
+}
+
+/*****************************************************************************************************************************************************
+** bool save(const string& path, Board& board, Player& player, Space* position, std::default_random_engine& rd,
+**           int phase, bool sync)
+******************************************************************************************************************************************************/
+bool Snapshot::save(const string& path, Board& board, Player& player, Space* position, std::default_random_engine& rd,
+                    int phase, bool sync){
+    string buffer;
+    try{
+        encode(buffer, board, player, position, rd, phase);
+    }
+    catch (string error){
+        return false;
+    }
+
+    string temporary = path + ".tmp";
+    int descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0){
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < buffer.size()){
+        ssize_t result = ::write(descriptor, buffer.data() + written, buffer.size() - written);
+        if (result <= 0){
+            break;
+        }
+        written += result;
+    }
+
+    bool ok = (written == buffer.size()) && (!sync || fsync(descriptor) == 0);
+    ok = (::close(descriptor) == 0) && ok;
+
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0){
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** Space* load(const string& path, Board& board, Player& player, std::default_random_engine& rd, int* phase, int phases)
+******************************************************************************************************************************************************/
+Space* Snapshot::load(const string& path, Board& board, Player& player, std::default_random_engine& rd, int* phase,
+                      int phases){
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return nullptr;
+    }
+
+    struct stat info;
+    string buffer;
+    if (fstat(descriptor, &info) == 0){
+        buffer.resize(info.st_size);
+    }
+
+    size_t done = 0;
+    while (done < buffer.size()){
+        ssize_t result = ::read(descriptor, &buffer[done], buffer.size() - done);
+        if (result <= 0){
+            break;
+        }
+        done += result;
+    }
+    ::close(descriptor);
+
+    if (buffer.empty() || done != buffer.size()){
+        return nullptr;
+    }
+    return decode(buffer.data(), buffer.size(), board, player, rd, phase, phases);
+}
@@ -0,0 +1,70 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Snapshot class, which saves a game in progress to a compact binary
+** file and restores it, so a game can outlive the process playing it. A snapshot holds everything the Spaces and
+** the Player would otherwise only hold in memory: the board's layout, which enemies have been fought, the portal
+** links, the player's position, strength, keys and victory, a battle still waiting for its wager, and the state of
+** the engine that makes the game's random choices.
+
+** Snapshots are written to a temporary file that is renamed over the old one, so a crash never leaves half a
+** snapshot behind, and read back with a single read(). Restoring rebuilds the cells in the board's existing arena
+** with Board::load_layout(), then sets the few cells whose state differs from a new board, so it takes time linear in
+** the board's cells (only the layout is rebuilt on a lazily built board) rather than in the state that was saved.
+
+** File layout (host byte order, which is little-endian on every machine the game builds for):
+    - Header:   the fixed-size Header struct below
+    - Layout:   rows * cols layout characters, as Board::getLayout() returns them
+    - Cells:    rows * cols bytes, FOUGHT for an enemy that has been fought, otherwise 0
+    - Portals:  one pair of int32 per built portal, its cell and its partner's cell. Portals are always paired in
+                the order they appear in the layout, and every one of them is built on a board that isn't lazy.
+******************************************************************************************************************************************************/
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+
+#include "Board.hpp"
+
+class Snapshot
+{
+    public:
+        static const uint32_t VERSION = 1;
+        static const unsigned char FOUGHT = 1;
+
+        struct Header
+        {
+            char     magic[4];                      //"TQSS"
+            uint32_t version;
+            int32_t  rows, cols, map_id;
+            int32_t  strength, keys;
+            uint8_t  victory, phase, battle_pending, reserved;
+            int32_t  position;                      //Index of the player's cell, row * cols + col
+            int32_t  enemy_strength, enemy_attack;  //The battle waiting for a wager, if battle_pending is set
+            int32_t  portals;                       //Number of portal pairs after the cells
+            char     engine[24];                    //The engine's state, as written by operator<<
+        };
+
+        //Writes the game into "buffer", reusing its memory. "phase" is saved as it is, for the caller's own use.
+        //Throws a string if the engine's state doesn't fit in the header.
+            static void encode(string& buffer, Board& board, Player& player, Space* position,
+                               std::default_random_engine& rd, int phase = 0);
+
+        //Restores a game written by encode() into "board", "player" and "rd" and returns the player's position.
+        //Throws a string if "data" isn't a valid snapshot, or its phase isn't below "phases", before anything has
+        //been changed.
+            static Space* decode(const char* data, size_t length, Board& board, Player& player,
+                                 std::default_random_engine& rd, int* phase = nullptr, int phases = 1);
+
+        //Writes the game to "path" through a temporary file renamed over it. With "sync", the file is flushed to disk
+        //before it is renamed. Returns false if it can't be written.
+            static bool save(const string& path, Board& board, Player& player, Space* position,
+                             std::default_random_engine& rd, int phase = 0, bool sync = true);
+
+        //Restores the game saved in "path". Returns nullptr if the file can't be read, and throws a string if it
+        //isn't a valid snapshot.
+            static Space* load(const string& path, Board& board, Player& player, std::default_random_engine& rd,
+                               int* phase = nullptr, int phases = 1);
+};
+
+#endif
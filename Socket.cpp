@@ -0,0 +1,126 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the socket helpers.
+******************************************************************************************************************************************************/
+#include "Socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/*****************************************************************************************************************************************************
+** is_port(const std::string& address)
+** True if the address is all digits, i.e. a TCP port rather than a socket path.
+******************************************************************************************************************************************************/
+static bool is_port(const std::string& address){
+    if (address.empty()){
+        return false;
+    }
+    for (char character : address){
+        if (character < '0' || character > '9'){
+            return false;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** make_socket(const std::string& address, sockaddr_storage& storage, socklen_t& length)
+** Creates a socket of the right family for "address" and fills in the address to bind or connect to.
+******************************************************************************************************************************************************/
+static int make_socket(const std::string& address, sockaddr_storage& storage, socklen_t& length){
+    std::memset(&storage, 0, sizeof(storage));
+    int fd;
+
+    if (is_port(address)){
+        sockaddr_in* inet = reinterpret_cast<sockaddr_in*>(&storage);
+        inet->sin_family = AF_INET;
+        inet->sin_port = htons(std::atoi(address.c_str()));
+        inet->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        length = sizeof(sockaddr_in);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+    }
+    else {
+        sockaddr_un* local = reinterpret_cast<sockaddr_un*>(&storage);
+        if (address.size() >= sizeof(local->sun_path)){
+            throw std::string("Socket path is too long: ") + address;
+        }
+        local->sun_family = AF_UNIX;
+        std::strcpy(local->sun_path, address.c_str());
+        length = sizeof(sockaddr_un);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    }
+
+    if (fd < 0){
+        throw std::string("Could not create a socket: ") + std::strerror(errno);
+    }
+    return fd;
+}
+
+/*****************************************************************************************************************************************************
+** open_listener(const std::string& address)
+** A stale socket file left at a Unix address by an earlier server is removed first.
+******************************************************************************************************************************************************/
+int open_listener(const std::string& address){
+    sockaddr_storage storage;
+    socklen_t length;
+    int fd = make_socket(address, storage, length);
+
+    if (is_port(address)){
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    else {
+        struct stat existing;
+        if (stat(address.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)){
+            unlink(address.c_str());
+        }
+    }
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&storage), length) < 0 || listen(fd, SOMAXCONN) < 0){
+        std::string error = std::string("Could not listen on ") + address + ": " + std::strerror(errno);
+        close(fd);
+        throw error;
+    }
+
+    set_nonblocking(fd);
+    return fd;
+}
+
+/*****************************************************************************************************************************************************
+** open_connection(const std::string& address)
+******************************************************************************************************************************************************/
+int open_connection(const std::string& address){
+    sockaddr_storage storage;
+    socklen_t length;
+    int fd = make_socket(address, storage, length);
+    set_nonblocking(fd);
+
+    if (is_port(address)){
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    if (connect(fd, reinterpret_cast<sockaddr*>(&storage), length) < 0 && errno != EINPROGRESS){
+        std::string error = std::string("Could not connect to ") + address + ": " + std::strerror(errno);
+        close(fd);
+        throw error;
+    }
+    return fd;
+}
+
+/*****************************************************************************************************************************************************
+** set_nonblocking(int fd)
+******************************************************************************************************************************************************/
+void set_nonblocking(int fd){
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
@@ -0,0 +1,21 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the socket helpers shared by the game server and its load generator.
+** An address is either a port number, for TCP on the loopback interface, or a path, for a Unix domain socket.
+** Both functions throw a string describing the failure.
+******************************************************************************************************************************************************/
+#ifndef SOCKET_HPP
+#define SOCKET_HPP
+
+#include <string>
+
+//Returns a non-blocking socket listening on "address".
+int open_listener(const std::string& address);
+
+//Returns a non-blocking socket connecting to "address". The connection may still be in progress.
+int open_connection(const std::string& address);
+
+void set_nonblocking(int fd);
+
+#endif
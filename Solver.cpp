@@ -0,0 +1,244 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Solver class.
+
+** The rules modelled here are the ones implemented by Space::move_player() and the interact() functions:
+    - Each move that leaves the current cell costs 1 strength point. Bumping into a mountain or the edge is free
+      but changes nothing, so the search never considers it.
+    - The game is lost as soon as strength reaches 0, unless the move that did it reached the vault with 4 keys.
+    - An enemy that hasn't been fought starts a battle when the player has fewer than 4 keys. Its maximum power is
+      uniform in [6, 10] and its attack uniform in [1, maximum]. The player sees the maximum and wagers [1, maximum].
+    - Strength is clamped at 0 after the wager. A win then returns half the wager and a key.
+******************************************************************************************************************************************************/
+#include "Solver.hpp"
+#include "Board.hpp"
+#include "DistanceCache.hpp"
+
+#include <algorithm>
+#include <queue>
+
+/*****************************************************************************************************************************************************
+** Solver(const BitBoard& board, const BoardDistances* distances)
+** Numbers the enemies in cell order and precomputes the distance from every cell to the vault.
+******************************************************************************************************************************************************/
+Solver::Solver(const BitBoard& board, const BoardDistances* distances) : board(board){
+    num_enemies = 0;
+    for (int cell = 0; cell < 64; cell++){
+        enemy_index[cell] = (board.getEnemies() & BitBoard::bit(cell)) ? num_enemies++ : -1;
+    }
+
+    table.reserve(1 << 16);
+    find_vault_distances(distances);
+}
+
+/*****************************************************************************************************************************************************
+** find_vault_distances(const BoardDistances* distances)
+** With "distances", one search backwards from the vault. Otherwise a breadth-first search from every cell,
+** following the same move rules as BitBoard::destination().
+** Once the player has 4 keys, the game is won exactly when the vault is within reach of their strength.
+******************************************************************************************************************************************************/
+void Solver::find_vault_distances(const BoardDistances* distances){
+    int cells = board.getRows() * board.getCols();
+    vault_distance.assign(cells, -1);
+
+    if (distances){
+        int vault = BitBoard::cell(board.getVault());
+        const std::vector<uint16_t>& to_vault = distances->towards(vault);
+        for (int start = 0; start < cells; start++){
+            if (!(board.getMountains() & BitBoard::bit(start)) && start != vault && to_vault[start] != DistanceMatrix::UNREACHABLE){
+                vault_distance[start] = to_vault[start];
+            }
+        }
+        return;
+    }
+
+    for (int start = 0; start < cells; start++){
+        if (board.getMountains() & BitBoard::bit(start)){
+            continue;
+        }
+
+        std::vector<int> distance(cells, -1);
+        std::queue<int> frontier;
+        distance[start] = 0;
+        frontier.push(start);
+
+        while (!frontier.empty() && vault_distance[start] < 0){
+            int cell = frontier.front();
+            frontier.pop();
+
+            for (int dir = 0; dir < BitBoard::NUM_DIRECTIONS; dir++){
+                int next = BitBoard::cell(board.destination(BitBoard::bit(cell), dir));
+                if (distance[next] >= 0){
+                    continue;
+                }
+                distance[next] = distance[cell] + 1;
+                if (board.getVault() & BitBoard::bit(next)){
+                    vault_distance[start] = distance[next];
+                    break;
+                }
+                frontier.push(next);
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** double value(int cell, int strength, int keys, uint32_t fought)
+** Max node: the best of the player's moves.
+******************************************************************************************************************************************************/
+double Solver::value(int cell, int strength, int keys, uint32_t fought){
+    if (keys >= 4){
+        return (vault_distance[cell] >= 0 && vault_distance[cell] <= strength) ? 1.0 : 0.0;
+    }
+
+    uint64_t key = pack(cell, strength, keys, fought);
+    std::unordered_map<uint64_t, double>::iterator found = table.find(key);
+    if (found != table.end()){
+        return found->second;
+    }
+
+    double best = 0.0;
+    BitBoard::Mask from = BitBoard::bit(cell), tried = from;
+    for (int dir = 0; dir < BitBoard::NUM_DIRECTIONS && best < 1.0; dir++){
+        BitBoard::Mask next = board.destination(from, dir);
+        if (next & tried){          //Blocked, or the same destination as an earlier direction
+            continue;
+        }
+        tried |= next;
+        best = std::max(best, arrive(BitBoard::cell(next), strength - 1, keys, fought));
+    }
+
+    table[key] = best;
+    return best;
+}
+
+/*****************************************************************************************************************************************************
+** double arrive(int cell, int strength, int keys, uint32_t fought)
+** The player has moved onto "cell" and paid the travel cost. Resolves the cell's interaction.
+******************************************************************************************************************************************************/
+double Solver::arrive(int cell, int strength, int keys, uint32_t fought){
+    BitBoard::Mask here = BitBoard::bit(cell);
+
+    if ((board.getVault() & here) && keys >= 4){
+        return 1.0;
+    }
+    if (strength <= 0){
+        return 0.0;
+    }
+
+    int enemy = enemy_index[cell];
+    if (keys >= 4 || enemy < 0 || (fought & (1u << enemy))){
+        return value(cell, strength, keys, fought);
+    }
+
+    //Chance node: the enemy's maximum power is uniform in [6, 10]
+    double total = 0.0;
+    for (int enemy_max = 6; enemy_max <= 10; enemy_max++){
+        total += battle(cell, strength, keys, fought, enemy_max, nullptr);
+    }
+    return total / 5.0;
+}
+
+/*****************************************************************************************************************************************************
+** double battle(int cell, int strength, int keys, uint32_t fought, int enemy_max, int* best_wager)
+** Max node over the wager, followed by a chance node over the enemy's attack: a wager of w against an attack
+** uniform in [1, enemy_max] wins with probability w / enemy_max.
+******************************************************************************************************************************************************/
+double Solver::battle(int cell, int strength, int keys, uint32_t fought, int enemy_max, int* best_wager){
+    uint32_t now_fought = fought | (1u << enemy_index[cell]);
+
+    //Larger wagers are tried first: a wager of enemy_max can't lose, so it often settles the battle at once.
+    double best = -1.0;
+    for (int wager = enemy_max; wager >= 1 && best < 1.0; wager--){
+        int after_wager = std::max(0, strength - wager);
+        int after_win = after_wager + wager / 2;
+
+        double win = (after_win > 0) ? value(cell, after_win, keys + 1, now_fought) : 0.0;
+        double lose = (after_wager > 0 && wager < enemy_max) ? value(cell, after_wager, keys, now_fought) : 0.0;
+
+        double expected = (wager * win + (enemy_max - wager) * lose) / enemy_max;
+        if (expected > best){
+            best = expected;
+            if (best_wager){
+                *best_wager = wager;
+            }
+        }
+    }
+    return best;
+}
+
+/*****************************************************************************************************************************************************
+** double win_probability(int strength)
+******************************************************************************************************************************************************/
+double Solver::win_probability(int strength){
+    return value(BitBoard::cell(board.getPosition()), strength, 0, 0);
+}
+
+/*****************************************************************************************************************************************************
+** char best_move(int cell, int strength, int keys, uint32_t fought)
+******************************************************************************************************************************************************/
+char Solver::best_move(int cell, int strength, int keys, uint32_t fought){
+    char best_move = DIRECTIONS[0].key;
+    double best = -1.0;
+    BitBoard::Mask from = BitBoard::bit(cell);
+    for (int dir = 0; dir < BitBoard::NUM_DIRECTIONS; dir++){
+        BitBoard::Mask next = board.destination(from, dir);
+        if (next == from){
+            continue;
+        }
+        double expected = arrive(BitBoard::cell(next), strength - 1, keys, fought);
+        if (expected > best){
+            best = expected;
+            best_move = DIRECTIONS[dir].key;
+        }
+    }
+    return best_move;
+}
+
+/*****************************************************************************************************************************************************
+** int best_wager(int cell, int strength, int keys, uint32_t fought, int enemy_max)
+******************************************************************************************************************************************************/
+int Solver::best_wager(int cell, int strength, int keys, uint32_t fought, int enemy_max){
+    int wager = enemy_max;
+    battle(cell, strength, keys, fought, enemy_max, &wager);
+    return wager;
+}
+
+/*****************************************************************************************************************************************************
+** char SolverPolicy::choose_move(Board* board, Space* position, Player* player)
+** Works out which enemies have been fought from the board itself, so the policy needs no memory of its own.
+******************************************************************************************************************************************************/
+char SolverPolicy::choose_move(Board* board, Space* position, Player* player){
+    if (!solver || layout != board->getLayout()){
+        layout = board->getLayout();
+        solver.reset(new Solver(BitBoard(layout, board->getRows(), board->getCols()), board->getDistances()));
+    }
+
+    fought = 0;
+    for (int cell = 0; cell < (int)layout.length(); cell++){
+        int enemy = solver->getEnemyIndex(cell);
+        if (enemy >= 0 && static_cast<Enemy*>(board->getCell(cell))->fought()){
+            fought |= uint32_t(1) << enemy;
+        }
+    }
+
+    char move = solver->best_move(board->getIndex(position), player->strength(), player->keys(), fought);
+
+    Space* next = position->getNeighbour(move_direction(move));
+    if (next && next->getType() == TELEPORT){
+        next = next->get_ot();
+    }
+    target = next ? board->getIndex(next) : -1;
+    return move;
+}
+
+/*****************************************************************************************************************************************************
+** int SolverPolicy::choose_wager(int enemy_strength, Player* player)
+******************************************************************************************************************************************************/
+int SolverPolicy::choose_wager(int enemy_strength, Player* player){
+    if (!solver || target < 0){
+        return enemy_strength;
+    }
+    return solver->best_wager(target, player->strength(), player->keys(), fought, enemy_strength);
+}
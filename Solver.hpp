@@ -0,0 +1,76 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Solver class. A Solver computes the best possible chance of
+** winning a particular board, assuming the player knows where every enemy is hidden. It runs an expectimax search
+** over states of (position, strength points, keys, enemies already fought), where the random enemy strength
+** and attack rolls of Enemy::interact() are chance nodes. Results are memoized in a transposition table.
+******************************************************************************************************************************************************/
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "BitBoard.hpp"
+#include "Policy.hpp"
+
+class BoardDistances;
+
+class Solver
+{
+    private:
+        BitBoard board;
+
+        int num_enemies;
+        int enemy_index[64];                    //Cell -> enemy number (bit in the "fought" mask), -1 if no enemy
+        std::vector<int> vault_distance;        //Moves needed to reach the vault from each cell, -1 if unreachable
+
+        std::unordered_map<uint64_t, double> table;     //Transposition table: packed state -> win probability
+
+        static uint64_t pack(int cell, int strength, int keys, uint32_t fought){
+            return uint64_t(fought) | (uint64_t(keys) << 32) | (uint64_t(strength) << 35) | (uint64_t(cell) << 48);
+        };
+
+        void   find_vault_distances(const BoardDistances* distances);
+        double arrive(int cell, int strength, int keys, uint32_t fought);    //Player has just paid to move onto "cell"
+        double battle(int cell, int strength, int keys, uint32_t fought, int enemy_max, int* best_wager);
+
+    public:
+        //"distances", if given, are the same board's (see Board::getDistances()) and save searching it for the vault
+            Solver(const BitBoard& board, const BoardDistances* distances = nullptr);
+
+        //Win probability with optimal play for a player standing on "cell" (after any interaction there).
+        //"fought" has bit i set if enemy i (numbered in cell order) has already been fought.
+            double value(int cell, int strength, int keys, uint32_t fought);
+
+        //Win probability from the board's starting position, as in main(): no keys, nothing fought.
+            double win_probability(int strength = 30);
+
+        //The move ('1'-'9') and battle wager that achieve value(). best_wager() is asked once the player has
+        //moved onto the enemy's cell and paid the travel cost.
+            char best_move(int cell, int strength, int keys, uint32_t fought);
+            int  best_wager(int cell, int strength, int keys, uint32_t fought, int enemy_max);
+
+        int getEnemyIndex(int cell){return enemy_index[cell];};
+        size_t states(){return table.size();};
+};
+
+//Plays the moves and wagers a Solver finds best. The Solver knows where every enemy is hidden, which a player doesn't,
+//so this is an upper bound for other policies rather than a fair opponent. The board must have at most 64 cells.
+class SolverPolicy : public Policy
+{
+    private:
+        std::unique_ptr<Solver> solver;
+        string   layout;                //Layout the solver was built for, so a new board gets a new solver
+        int      target;                //Cell the last move leads to, where a battle would be
+        uint32_t fought;                //Enemies fought before the last move
+
+    public:
+        SolverPolicy() : target(-1), fought(0){};
+        virtual char choose_move(Board*, Space*, Player*);
+        virtual int  choose_wager(int enemy_strength, Player*);
+};
+
+#endif
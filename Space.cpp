@@ -5,23 +5,27 @@
 ** and its derived classes.
 ******************************************************************************************************************************************************/
 #include "Space.hpp"
+#include "Policy.hpp"
+#include "Metrics.hpp"
+#include "WagerTable.hpp"
 
 /*****************************************************************************************************************************************************
 ** Base()
 ** Base constructor. Initializes data members.
 ******************************************************************************************************************************************************/
-Space::Space(char sprite){
-    this->sprite = sprite;
+Space::Space(char sprite, CellType type) : occupants(sprite == 'x'){
+    this->type = type;
 
-    left = right = top = bottom = top_left = 
-    top_right = bottom_left = bottom_right = nullptr;
+    for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+        neighbours[dir] = nullptr;
+    }
 }
 
 /*****************************************************************************************************************************************************
 ** Mountain()
 ** Mountain constructor. Sets default sprite and calls Space constructor.
 ******************************************************************************************************************************************************/
-Mountain::Mountain(char icon) : Space(icon){
+Mountain::Mountain(char icon) : Space(icon, MOUNTAIN){
     default_sprite = 'A';
 }
 
@@ -35,9 +39,9 @@ void Mountain::interact(Player* player){
 
 /*****************************************************************************************************************************************************
 ** Teleport()
-** Teleport constructor. Sets default sprite and calls Space constructor.
+** Teleport constructor. Sets default sprite and calls Space constructor. The partner is set once the board is built.
 ******************************************************************************************************************************************************/
-Teleport::Teleport(char icon) : Space(icon){
+Teleport::Teleport(char icon) : Space(icon, TELEPORT), other_teleport(nullptr){
     default_sprite = 'O';
 }
 
@@ -46,15 +50,17 @@ Teleport::Teleport(char icon) : Space(icon){
 ******************************************************************************************************************************************************/
 void Teleport::interact(Player* player){
     travel_cost(player);
-    cout << "Prepare to teleport! " << endl;
-    sprite = 'x';
+    if (std::ostream* out = player->log()){
+        *out << "Prepare to teleport! \n";
+    }
+    arrive();
 }
 
 /*****************************************************************************************************************************************************
 ** Finish()
 ** Finish constructor. Sets default sprite and calls Space constructor.
 ******************************************************************************************************************************************************/
-Finish::Finish(char icon) : Space(icon){
+Finish::Finish(char icon) : Space(icon, VAULT){
     default_sprite = '!';
 }
 
@@ -64,15 +70,21 @@ Finish::Finish(char icon) : Space(icon){
 ******************************************************************************************************************************************************/
 void Finish::interact(Player* player){
     travel_cost(player);
-    sprite = 'x';
+    arrive();
+
+    std::ostream* out = player->log();
 
     if (player->keys() < 4){
-        cout << "You've reached the vault!\nBut you've only acquired " << player->keys() << " keys.\n"
-        "Return with 4 keys to unlock the treasure within!" << endl;
+        if (out){
+            *out << "You've reached the vault!\nBut you've only acquired " << player->keys() << " keys.\n"
+            "Return with 4 keys to unlock the treasure within!\n";
+        }
         return;
     }
 
-    cout << "You've reached the vault with all 4 keys and reclaimed the family treasure!" << endl;
+    if (out){
+        *out << "You've reached the vault with all 4 keys and reclaimed the family treasure!\n";
+    }
 
     player->flip_victory();
 }
@@ -81,79 +93,162 @@ void Finish::interact(Player* player){
 ** Enemy()
 ** Enemy constructor. Sets default sprite, "already_fought", and calls Space constructor.
 ******************************************************************************************************************************************************/
-Enemy::Enemy(char icon) : Space(icon){
+Enemy::Enemy(char icon) : Space(icon, ENEMY){
     default_sprite = '.';
     already_fought = false;
+    battle_pending = false;
+    enemy_strength = enemy_attack = 0;
 }
 
 /*****************************************************************************************************************************************************
 ** Finish::interact(Player* player)
 ** Runs the combat subroutine if the following conditions are met:
     - Player has at least 1 strength point
-    - This Space's combat subroutine has not already been run
+    - This Space's combat subroutine has not already been run, or claimed by another player on a shared board
     - The player has not acquired the 4 keys needed for victory
 
 ** Combat flows as follows:
     - Maximum power of the enemy is randomly chosen [6, 10]
     - Actual enemy attack is chosen [1, max power]
-    - Player wagers [1, max power] strength points, which are decremented from their total
+    - Player wagers [1, max power] strength points, which are decremented from their total. The wager comes
+      from the Player's Policy if it has one, otherwise it is read from the keyboard.
     - If player attack >= enemy attack, player wins. Recovers half of wagered strength points and gains a key
     - Otherwise, all strength points wagered remain lost.
 ******************************************************************************************************************************************************/
 void Enemy::interact(Player* player){
 
     travel_cost(player);
-    sprite = 'x';
+    arrive();
 
     //Stop here if player has no strength points left
     if (!player->status()){
         return;
     }
 
-    if (!already_fought && (player->keys() < 4)){
-        //Initialize and seed a random number engine
-        std::default_random_engine rd;
-        std::random_device seed_gen{};
-        rd.seed(seed_gen());
+    std::ostream* out = player->log();
+
+    //On a shared board, many players may arrive at once. Only the first to claim the enemy fights it.
+    if ((player->keys() < 4) && !already_fought.load(std::memory_order_relaxed)
+        && !already_fought.exchange(true, std::memory_order_acq_rel)){
+        Metrics::Timer timer(Metrics::COMBAT);
+
+        //Use the player's engine if it has one. Otherwise, initialize and seed a random number engine
+        std::default_random_engine local_rd;
+        if (!player->rng()){
+            std::random_device seed_gen{};
+            local_rd.seed(seed_gen());
+        }
+        std::default_random_engine& rd = player->rng() ? *player->rng() : local_rd;
 
-        cout << "You've found one of the bandits! Prepare for battle!\n\n";
+        if (out){
+            *out << "You've found one of the bandits! Prepare for battle!\n\n";
+        }
         
         //Randomly generate enemy attack.
-        int enemy_strength = std::uniform_int_distribution<int>{6, 10}(rd);
-        int enemy_attack = std::uniform_int_distribution<int>{1, enemy_strength}(rd);
-
-        cout << "The bandit has a maximum attack of " << enemy_strength << "\n"
-        "How many strength points would you like to wager? (1 to " << enemy_strength << ") ";
+        enemy_strength = std::uniform_int_distribution<int>{6, 10}(rd);
+        enemy_attack = std::uniform_int_distribution<int>{1, enemy_strength}(rd);
+
+        if (out){
+            *out << "The bandit has a maximum attack of " << enemy_strength << "\n";
+
+            //Hint mode suggests the wager from the precomputed table, see WagerTable.hpp, with what to expect from it:
+            //the chance of winning the battle, the strength points left on average, and the table's chance of winning
+            //the game from there.
+            if (player->hints()){
+                int hint = WagerTable::best_wager(enemy_strength, player->keys(), player->strength());
+                float chance = float(hint) / enemy_strength;
+                float expected = std::max(player->strength() - hint, 0) + chance * (hint / 2);
+                float game = WagerTable::win_chance(enemy_strength, player->keys(), player->strength());
+                *out << "Hint: wager " << hint << ". You'd win this battle " << int(100 * chance + 0.5f) << "% of the time "
+                << "and have " << int(expected + 0.5f) << " strength points afterwards on average, with a "
+                << int(100 * game + 0.5f) << "% chance of winning the game if each bandit is " << WagerTable::ENEMY_MOVES
+                << " moves from the last.\n";
+            }
+
+            *out << "How many strength points would you like to wager? (1 to " << enemy_strength << ") ";
+        }
         
-        //Get player's wager, subtract it from their strength points.
+        //Get player's wager. A Policy may defer the wager, in which case the battle waits for resolve_wager().
         int wager;
-        ValidateInt(wager, 1, enemy_strength);
-        player->dec_strength(wager);
-
-        cout << "Strength points remaining: " << player->strength() << "\n"
-        << "Enemy attack: " << enemy_attack << "\n" << endl;
-        
-        //Check if player's attack is enough to defeat the enemy.
-        if (wager >= enemy_attack){
-            cout << "You've defeated the bandit and recovered a key!\n" << endl;
-            player->add_key();
-            player->dec_strength(-(wager / 2));
-            cout << "You've also recovered half of the strength points that you wagered.\n"
-            "Strength points remaining: " << player->strength() << endl;
+        if (player->controller()){
+            wager = player->controller()->choose_wager(enemy_strength, player);
+            if (wager == Policy::DEFER){
+                battle_pending = true;
+                return;
+            }
         }
         else {
-            cout << "You failed to defeat the bandit. He escapes with a key.\n"
-            "Strength points remaining: " << player->strength() << endl;
+            ValidateInt(wager, 1, enemy_strength);
         }
 
-        already_fought = true;
+        finish_battle(player, wager);
+    }
+    else if (out){
+        *out << "None of the bandits have been seen here. You stop and rest for the night.\n";
+    }
+}
+
+/*****************************************************************************************************************************************************
+** Enemy::restore(bool fought, bool pending, int strength, int attack)
+** Puts the enemy back in the state saved by a Snapshot, including a battle still waiting for its wager.
+******************************************************************************************************************************************************/
+void Enemy::restore(bool fought, bool pending, int strength, int attack){
+    already_fought = fought;
+    battle_pending = pending;
+    enemy_strength = strength;
+    enemy_attack = attack;
+}
 
-        cout << "Press Enter to continue: ";
-        string temp;
-        getline(cin, temp);
+/*****************************************************************************************************************************************************
+** Enemy::resolve_wager(Player* player, int wager)
+** Finishes a battle whose wager was deferred by the Player's Policy. Does nothing if no battle is waiting.
+******************************************************************************************************************************************************/
+void Enemy::resolve_wager(Player* player, int wager){
+    if (!battle_pending){
+        return;
+    }
+    battle_pending = false;
+    finish_battle(player, wager);
+}
+
+/*****************************************************************************************************************************************************
+** Enemy::finish_battle(Player* player, int wager)
+** Subtracts the wager from the player's strength points and decides the battle.
+******************************************************************************************************************************************************/
+void Enemy::finish_battle(Player* player, int wager){
+    std::ostream* out = player->log();
+
+    player->dec_strength(wager);
+
+    if (out){
+        *out << "Strength points remaining: " << player->strength() << "\n"
+        << "Enemy attack: " << enemy_attack << "\n\n";
+    }
+    
+    //Check if player's attack is enough to defeat the enemy.
+    if (wager >= enemy_attack){
+        Metrics::count(Metrics::BATTLES_WON);
+        player->add_key();
+        player->dec_strength(-(wager / 2));
+        if (out){
+            *out << "You've defeated the bandit and recovered a key!\n\n";
+            *out << "You've also recovered half of the strength points that you wagered.\n"
+            "Strength points remaining: " << player->strength() << "\n";
+        }
     }
     else {
-        cout << "None of the bandits have been seen here. You stop and rest for the night." << endl;
+        Metrics::count(Metrics::BATTLES_LOST);
+        if (out){
+            *out << "You failed to defeat the bandit. He escapes with a key.\n"
+            "Strength points remaining: " << player->strength() << "\n";
+        }
+    }
+
+    //Only a person at the keyboard needs a pause to read the outcome.
+    if (!player->controller()){
+        *out << "Press Enter to continue: ";
+        string temp;
+        getline(cin, temp);
     }
 }
 
@@ -161,7 +256,7 @@ void Enemy::interact(Player* player){
 ** Blank constructor. updates the various space attributes to those of a Blank
 ** 'name' parameter is optional. If no name is passed, a default value is used ("Blank").
 ******************************************************************************************************************************************************/
-Blank::Blank(char icon) : Space(icon){
+Blank::Blank(char icon) : Space(icon, OPEN){
     default_sprite = '.';
 }
 
@@ -170,57 +265,65 @@ Blank::Blank(char icon) : Space(icon){
 ******************************************************************************************************************************************************/
 void Blank::interact(Player* player){
     travel_cost(player);
-    cout << "None of the bandits have been seen here. You stop and rest for the night." << endl;
-    sprite = 'x';
+    if (std::ostream* out = player->log()){
+        *out << "None of the bandits have been seen here. You stop and rest for the night.\n";
+    }
+    arrive();
+}
+
+/*****************************************************************************************************************************************************
+** Frontier()
+** Frontier constructor. "icon" is the sprite of the cell it stands for, so the board can be drawn without building it.
+******************************************************************************************************************************************************/
+Frontier::Frontier(char icon, CellSource* owner, int64_t cell) : Space(icon, UNBUILT){
+    default_sprite = icon;
+    this->owner = owner;
+    this->cell = cell;
 }
 
 /*****************************************************************************************************************************************************
 ** Space::move_player(char move, Player* player)
 ** Called by the player's current space to move to the next space. Returns a pointer to the next space.
+** The move character is one of the default controls and is looked up in the direction table (see Grid.hpp). The
+** neighbour pointers were set when the board was linked, so nothing here depends on the size of the board.
 ******************************************************************************************************************************************************/
 Space* Space::move_player(char move, Player* player){
-    Space* ptr_to_next=nullptr;
-    
-    switch(move){
-        case('1'):  ptr_to_next = bottom_left;
-                    break;
-        case('2'):  ptr_to_next = bottom;
-                    break;
-        case('3'):  ptr_to_next = bottom_right;
-                    break;
-        case('4'):  ptr_to_next = left;
-                    break;
-        case('6'):  ptr_to_next = right;
-                    break;
-        case('7'):  ptr_to_next = top_left;
-                    break;
-        case('8'):  ptr_to_next = top;
-                    break;
-        case('9'):  ptr_to_next = top_right;
-                    break;
-    }
+    Metrics::Timer timer(Metrics::MOVE);
+
+    int dir = move_direction(move);
+    Space* ptr_to_next = (dir < 0) ? nullptr : neighbours[dir];
 
     //Spaces are initialized with all adjacent pointers set to null. If a space is on the edge of
     //the board, the appropriate spaces remain set to null.
 
+    //Cells of a lazily built board are built the first time a move reaches them
+    if (ptr_to_next && ptr_to_next->getType() == UNBUILT){
+        ptr_to_next = ptr_to_next->materialize();
+    }
+
     if (!ptr_to_next){
-        cout << "You cannot move off the edge of the board" << endl;
+        timer.count(Metrics::EDGE_BUMPS);
+        if (std::ostream* out = player->log()){
+            *out << "You cannot move off the edge of the board\n";
+        }
         return this;
     }
     
-    char next_sprite = ptr_to_next->getSprite();
-
-    switch(next_sprite){
+    switch(ptr_to_next->getType()){
         //Case Mountain: Player can't move, return current postition as next position
-        case('A'):  cout << "A mountain blocks your path..." << endl;
-                    return this;
+        case(MOUNTAIN): timer.count(Metrics::MOUNTAIN_BUMPS);
+                        if (std::ostream* out = player->log()){
+                            *out << "A mountain blocks your path...\n";
+                        }
+                        return this;
 
         //Case Teleport: Return the pointer to the other Teleport space
-        case('O'):  ptr_to_next = ptr_to_next->get_ot();
+        case(TELEPORT): timer.count(Metrics::TELEPORTS);
+                        ptr_to_next = ptr_to_next->get_ot();
         
         //If execution arrives here, the player will be moved from the current space, so the
-        //current space's sprite must be reset to its default.
-        default:    sprite = default_sprite;
+        //player leaves the current space.
+        default:        leave();
     }
 
     //Call the next Space's interact function.
@@ -235,12 +338,17 @@ Space* Space::move_player(char move, Player* player){
 ******************************************************************************************************************************************************/
 void Space::travel_cost(Player* player){
     player->dec_strength(1);
+
+    std::ostream* out = player->log();
+    if (!out){
+        return;
+    }
     
-    cout << "Your travels have made you weary. You have " <<  player->strength()
+    *out << "Your travels have made you weary. You have " <<  player->strength()
     << " strength point";
 
     if (player->strength() != 1){
-        cout << 's';
+        *out << 's';
     }
-    cout << " remaining.\n" << endl;
+    *out << " remaining.\n\n";
 }
\ No newline at end of file
@@ -3,50 +3,61 @@
 ** Date: 12/06/19
 ** Description: This is the interface file for the Space class. A Board object pointing to a
 ** number of Space objects is used to play Treasure Quest.
+
+** Many players can share one board and move at the same time from different threads (see Race.hpp). The only
+** state a move changes on the board is how many players are on each space and whether each enemy has been fought,
+** and both are atomic, so no locks are needed. A shared board must be built eagerly: building a cell on demand
+** (see Frontier) is not safe to do from more than one thread.
 ******************************************************************************************************************************************************/
 #ifndef SPACE_HPP 
 #define SPACE_HPP
 
+#include <atomic>
 #include <random>
+#include <cstdint>
 #include "Player.hpp"
 #include "menu.hpp"
+#include "Grid.hpp"
 
 using std::cout;
 using std::endl;
 using std::string;
 
+//What a Space is, independent of how it's drawn. Move resolution depends on this rather than on the sprite.
+//UNBUILT is a Frontier, which stands in for a cell that is built on demand (see Board.hpp and World.hpp).
+enum CellType {OPEN, MOUNTAIN, TELEPORT, VAULT, ENEMY, UNBUILT};
+
 class Space
 {
     protected:
-        //Each Space object contains pointers to up to 8 other adjacent Space objects
-            
-            Space *left, *right, *top, *bottom;         //Pointers to horizontally adjacent spaces
-            Space *top_left, *top_right,                //Pointers to diagonally adjacent spaces
-            *bottom_left, *bottom_right;
+        //Each Space object contains pointers to up to 8 other adjacent Space objects, indexed by direction
+        //(see DIRECTIONS in Grid.hpp). nullptr where the direction leads off the board.
+            Space* neighbours[NUM_DIRECTIONS];
+
+        CellType type;                  //Set by each derived type's constructor
         
-        //When the game board is written to the terminal a character is used to represent each Space.
-        //The Space's "sprite" data member contains that character.
-            
-            char default_sprite,        //The sprite ordinarily used by the Space, depends on the derived type.
+        //When the game board is written to the terminal a character is used to represent each Space: 'x' if a
+        //player is on it, otherwise its "default_sprite", which depends on the derived type.
+            char default_sprite;
 
-            sprite;                     //The sprite currently used by the space. If the space is currently
-                                        //occupied by the player, sprite = 'x'. Otherwise, sprite = default_sprite.
+        std::atomic<uint16_t> occupants;    //Players on the space. Only a shared board has more than one.
 
     public:
-        Space(char);        //Sets eight position pointers to null and sprite to the passed char value
+        Space(char, CellType);      //Sets the eight neighbour pointers to null. 'x' for the space the player starts on.
+        virtual ~Space(){};
 
-        //Setter methods for each of the eight pointers
-            void setLeft    (Space* sp_ptr){left = sp_ptr;};
-            void setRight   (Space* sp_ptr){right = sp_ptr;};
-            void setTop     (Space* sp_ptr){top = sp_ptr;};
-            void setBottom  (Space* sp_ptr){bottom = sp_ptr;};
+        //Getter and setter for the neighbour in direction "dir"
+            void   setNeighbour(int dir, Space* sp_ptr){neighbours[dir] = sp_ptr;};
+            Space* getNeighbour(int dir){return neighbours[dir];};
 
-            void setTopLeft     (Space* sp_ptr){top_left  = sp_ptr;};
-            void setTopRight    (Space* sp_ptr){top_right  = sp_ptr;};
-            void setBottomLeft  (Space* sp_ptr){bottom_left  = sp_ptr;};
-            void setBottomRight (Space* sp_ptr){bottom_right  = sp_ptr;};
+        char     getSprite(){return occupants.load(std::memory_order_relaxed) ? 'x' : default_sprite;};
+        CellType getType(){return type;};
+        int      getOccupants(){return occupants.load(std::memory_order_relaxed);};
+        void     set_occupied(bool occupied){occupants.store(occupied, std::memory_order_relaxed);};   //Used when restoring a game
 
-        char getSprite(){return sprite;};
+        //Called when a player arrives on the space or leaves it
+            void arrive(){occupants.fetch_add(1, std::memory_order_relaxed);};
+            void leave(){occupants.fetch_sub(1, std::memory_order_relaxed);};
 
         Space* move_player(char, Player*);  //Returns a pointer to the space the player wants to move to,
                                             //with the char parameter representing 1 of 8 move choices.
@@ -57,10 +68,19 @@ class Space
         void   travel_cost(Player*);        //Called by each derived type's interact() function (except Mountain).
                                             //Reduces the Player's strength points by 1.
 
+        //These functions are overridden by and only used by Enemy objects. A battle is left waiting when the
+        //Player's Policy defers its wager (see Policy::DEFER), and finished once the wager is known.
+            virtual bool awaiting_wager(){return false;};
+            virtual int  wager_limit(){return 0;};
+            virtual void resolve_wager(Player*, int){return;};
+
         //These functions are overridden by and only used by Teleport objects. Defined here as well to
         //allow full polymorphic behavior using Space pointers.
             virtual void set_other_teleport(Space*){return;};
             virtual Space* get_ot(){return nullptr;};
+
+        //Overridden by Frontier. Returns the Space that really belongs at this address, building it if necessary.
+            virtual Space* materialize(){return this;};
 };
 
 //Mountain spaces simply don't allow the player to occupy them.
@@ -83,7 +103,7 @@ class Teleport : public Space
             virtual void set_other_teleport(Space* other_teleport){this->other_teleport = other_teleport;};
             virtual Space* get_ot(){return other_teleport;};
 
-        //Calls travel_cost(), displays dialogue, changes "sprite" to 'x'
+        //Calls travel_cost(), displays dialogue, marks the space occupied
             virtual void interact(Player*);
 };
 
@@ -92,7 +112,7 @@ class Finish : public Space
     public:
         Finish(char icon);
 
-        //Calls travel_cost(), displays dialogue, changes "sprite" to 'x'
+        //Calls travel_cost(), displays dialogue, marks the space occupied
         //Also checks if the game-winning condition has been achieved and updates Player's "victory" parameter if so
             virtual void interact(Player*);
 };
@@ -100,21 +120,56 @@ class Finish : public Space
 class Enemy : public Space
 {
     private:
-        bool already_fought;        //Initialized to "false", flipped to "true" after enemy is fought once
+        std::atomic<bool> already_fought;   //Initialized to "false", flipped to "true" by the one player who fights it
+        bool battle_pending;        //True while a battle waits for a deferred wager
+        int  enemy_strength,        //Maximum and actual attack of the current battle
+             enemy_attack;
+
+        void finish_battle(Player*, int wager);
 
     public:
         Enemy(char icon);
-        //Calls travel_cost(), displays dialogue, changes "sprite" to 'x'
+        //Calls travel_cost(), displays dialogue, marks the space occupied
         //Also implements the combat subroutine and modifies the Player object accordingly.
             virtual void interact(Player*);
+
+        virtual bool awaiting_wager(){return battle_pending;};
+        virtual int  wager_limit(){return enemy_strength;};
+        virtual void resolve_wager(Player*, int wager);
+
+        //Used to save and restore a battle, see Snapshot.hpp
+            bool fought(){return already_fought.load(std::memory_order_relaxed);};
+            int  attack(){return enemy_attack;};
+            void restore(bool fought, bool pending, int strength, int attack);
 };
 
 class Blank : public Space
 {
     public:
         Blank(char icon);
-        //Calls travel_cost(), displays dialogue, changes "sprite" to 'x'
+        //Calls travel_cost(), displays dialogue, marks the space occupied
             virtual void interact(Player*);
 };
 
+//Anything that builds cells on demand: a lazily built Board, or a World that pages chunks in and out.
+class CellSource
+{
+    public:
+        virtual Space* materialize(int64_t cell) = 0;   //The Space for cell "cell" (row * cols + col), built if necessary
+        virtual ~CellSource(){};
+};
+
+//Stands in for a cell that hasn't been built. A move onto a Frontier asks its CellSource for the real Space: a lazily
+//built Board replaces the Frontier with it in place, and a World looks it up in whichever chunk holds it.
+class Frontier : public Space
+{
+    private:
+        CellSource* owner;
+        int64_t     cell;
+    public:
+        Frontier(char icon, CellSource* owner, int64_t cell);
+        virtual void interact(Player*){return;};   //Never called: move_player() materializes the cell first
+        virtual Space* materialize(){return owner->materialize(cell);};
+};
+
 #endif
@@ -0,0 +1,137 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the ThreadPool class.
+******************************************************************************************************************************************************/
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+static thread_local int current_worker = -1;
+
+/*****************************************************************************************************************************************************
+** ThreadPool(int num_threads)
+** Starts the worker threads.
+******************************************************************************************************************************************************/
+ThreadPool::ThreadPool(int num_threads) : queued(0), pending(0), next_queue(0), stopping(false){
+    if (num_threads <= 0){
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (int worker = 0; worker < num_threads; worker++){
+        queues.push_back(new TaskQueue);
+    }
+    for (int worker = 0; worker < num_threads; worker++){
+        threads.push_back(std::thread(&ThreadPool::run, this, worker));
+    }
+}
+
+/*****************************************************************************************************************************************************
+** ~ThreadPool()
+** Finishes any remaining tasks, then stops and joins the worker threads.
+******************************************************************************************************************************************************/
+ThreadPool::~ThreadPool(){
+    wait();
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    for (TaskQueue* queue : queues){
+        delete queue;
+    }
+}
+
+/*****************************************************************************************************************************************************
+** submit(std::function<void()> task)
+** Queues a task on the next worker in round-robin order and wakes a sleeping worker.
+******************************************************************************************************************************************************/
+void ThreadPool::submit(std::function<void()> task){
+    pending++;
+
+    TaskQueue* queue = queues[next_queue++ % queues.size()];
+    {
+        std::lock_guard<std::mutex> guard(queue->lock);
+        queue->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        queued++;
+    }
+    work_available.notify_one();
+}
+
+/*****************************************************************************************************************************************************
+** wait()
+******************************************************************************************************************************************************/
+void ThreadPool::wait(){
+    std::unique_lock<std::mutex> lock(idle_lock);
+    all_done.wait(lock, [this]{return pending == 0;});
+}
+
+/*****************************************************************************************************************************************************
+** int worker_index()
+******************************************************************************************************************************************************/
+int ThreadPool::worker_index(){
+    return current_worker;
+}
+
+/*****************************************************************************************************************************************************
+** bool take(int worker, std::function<void()>& task)
+** Takes the newest task from the worker's own queue or, failing that, the oldest task from another worker's queue.
+******************************************************************************************************************************************************/
+bool ThreadPool::take(int worker, std::function<void()>& task){
+    int num_queues = queues.size();
+    for (int offset = 0; offset < num_queues; offset++){
+        TaskQueue* queue = queues[(worker + offset) % num_queues];
+
+        std::lock_guard<std::mutex> guard(queue->lock);
+        if (queue->tasks.empty()){
+            continue;
+        }
+
+        if (offset == 0){
+            task = std::move(queue->tasks.back());
+            queue->tasks.pop_back();
+        }
+        else {
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+        }
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+/*****************************************************************************************************************************************************
+** run(int worker)
+** Worker thread loop. Sleeps only when every queue is empty.
+******************************************************************************************************************************************************/
+void ThreadPool::run(int worker){
+    current_worker = worker;
+
+    std::function<void()> task;
+    while (true){
+        if (take(worker, task)){
+            task();
+            task = nullptr;
+
+            if (--pending == 0){
+                std::lock_guard<std::mutex> guard(idle_lock);
+                all_done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_lock);
+        work_available.wait(lock, [this]{return queued > 0 || stopping;});
+        if (stopping && queued == 0){
+            return;
+        }
+    }
+}
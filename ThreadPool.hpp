@@ -0,0 +1,54 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the ThreadPool class, a work-stealing pool used by the simulators.
+** Each worker thread has its own task queue. A worker takes tasks from the back of its own queue and, when that
+** runs dry, steals from the front of the other workers' queues, so uneven batches still keep every core busy.
+******************************************************************************************************************************************************/
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+    private:
+        struct TaskQueue
+        {
+            std::deque<std::function<void()>> tasks;
+            std::mutex lock;
+        };
+
+        std::vector<TaskQueue*>  queues;            //One per worker
+        std::vector<std::thread> threads;
+
+        std::atomic<int>      queued;               //Tasks sitting in a queue
+        std::atomic<int>      pending;              //Tasks submitted but not yet finished
+        std::atomic<unsigned> next_queue;           //Round-robin target for submit()
+        bool                  stopping;
+
+        std::mutex              idle_lock;
+        std::condition_variable work_available, all_done;
+
+        bool take(int worker, std::function<void()>& task);
+        void run(int worker);
+
+    public:
+        ThreadPool(int num_threads = 0);            //0 uses one thread per hardware thread
+        ~ThreadPool();
+
+        void submit(std::function<void()> task);
+        void wait();                                //Blocks until every submitted task has finished
+
+        int size(){return threads.size();};
+
+        static int worker_index();                  //Index of the calling worker thread, -1 if not a worker
+};
+
+#endif
@@ -0,0 +1,178 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the Tournament class.
+******************************************************************************************************************************************************/
+#include "Tournament.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+const double Z_95 = 1.96;
+
+//The independent random streams of one game
+enum Stream {BOARD_STREAM, BATTLE_STREAM, POLICY_STREAM};
+
+/*****************************************************************************************************************************************************
+** unsigned stream_seed(unsigned seed, long game, Stream stream)
+** Mixes the tournament's seed, the game and the stream through a seed_seq, so no two of them share a seed and nearby
+** seeds don't give related engines.
+******************************************************************************************************************************************************/
+static unsigned stream_seed(unsigned seed, long game, Stream stream){
+    std::seed_seq sequence{uint32_t(seed), uint32_t(game), uint32_t(uint64_t(game) >> 32), uint32_t(stream)};
+    uint32_t result;
+    sequence.generate(&result, &result + 1);
+    return result;
+}
+
+/*****************************************************************************************************************************************************
+** Tournament constructor
+** maps - Templates to build boards from. Must outlive the tournament.
+******************************************************************************************************************************************************/
+Tournament::Tournament(const std::vector<MapTemplate>& maps, int starting_strength, int max_moves) :
+    maps(maps), starting_strength(starting_strength), max_moves(max_moves){
+}
+
+/*****************************************************************************************************************************************************
+** add(const string& name, Factory make)
+******************************************************************************************************************************************************/
+void Tournament::add(const string& name, Factory make){
+    Entry entry = {name, make};
+    entries.push_back(entry);
+}
+
+/*****************************************************************************************************************************************************
+** run(long games, int threads, unsigned seed)
+** Each worker builds a game's board once and plays every policy on a fresh copy of it (see Board::load_layout()),
+** with a battle engine seeded the same way for each, and each policy seeded from the game's own stream.
+******************************************************************************************************************************************************/
+std::vector<Tournament::Standing> Tournament::run(long games, int threads, unsigned seed){
+    int policies = entries.size();
+    ThreadPool pool(threads);
+
+    std::vector<std::vector<Tally>> tallies(pool.size(), std::vector<Tally>(policies, Tally()));
+    std::vector<std::unique_ptr<Board>> boards(pool.size());
+
+    for (long first = 0; first < games; first += GAMES_PER_TASK){
+        long last = std::min<long>(first + GAMES_PER_TASK, games);
+
+        pool.submit([this, &tallies, &boards, first, last, seed, policies]{
+            int worker = ThreadPool::worker_index();
+            std::vector<Tally>& tally = tallies[worker];
+            std::vector<GameResult> results(policies);
+
+            for (long game = first; game < last; game++){
+                std::default_random_engine board_rd(stream_seed(seed, game, BOARD_STREAM));
+                unsigned battle_seed = stream_seed(seed, game, BATTLE_STREAM);
+                unsigned policy_seed = stream_seed(seed, game, POLICY_STREAM);
+
+                if (!boards[worker]){
+                    boards[worker].reset(new Board(maps, board_rd));
+                }
+                else {
+                    boards[worker]->reset(maps, board_rd);
+                }
+                Board& board = *boards[worker];
+                string layout = board.getLayout();
+
+                for (int policy = 0; policy < policies; policy++){
+                    if (policy > 0){
+                        board.load_layout(layout);
+                    }
+                    std::default_random_engine battle_rd(battle_seed);
+                    std::unique_ptr<Policy> player(entries[policy].make(policy_seed));
+                    results[policy] = play_headless(player.get(), &board, battle_rd, starting_strength, max_moves);
+
+                    const GameResult& result = results[policy];
+                    double difference = double(result.won) - double(results[0].won);
+                    Tally& sums = tally[policy];
+                    sums.games++;
+                    sums.wins += result.won;
+                    sums.strength += result.strength;
+                    sums.strength_sq += double(result.strength) * result.strength;
+                    sums.moves += result.moves;
+                    sums.moves_sq += double(result.moves) * result.moves;
+                    sums.difference += difference;
+                    sums.difference_sq += difference * difference;
+                }
+            }
+        });
+    }
+    pool.wait();
+
+    //Combine the per-worker tallies
+    std::vector<Standing> standings;
+    for (int policy = 0; policy < policies; policy++){
+        Tally total = Tally();
+        for (std::vector<Tally>& tally : tallies){
+            total.games += tally[policy].games;
+            total.wins += tally[policy].wins;
+            total.strength += tally[policy].strength;
+            total.strength_sq += tally[policy].strength_sq;
+            total.moves += tally[policy].moves;
+            total.moves_sq += tally[policy].moves_sq;
+            total.difference += tally[policy].difference;
+            total.difference_sq += tally[policy].difference_sq;
+        }
+
+        Standing standing;
+        standing.name = entries[policy].name;
+        standing.games = total.games;
+        standing.win_rate = estimate(total.wins, total.wins, total.games);     //Wins are 0 or 1, so the sum of squares is the sum
+        standing.strength = estimate(total.strength, total.strength_sq, total.games);
+        standing.moves = estimate(total.moves, total.moves_sq, total.games);
+        standing.difference = estimate(total.difference, total.difference_sq, total.games);
+        standings.push_back(standing);
+    }
+
+    //Two independent win rates would have the sum of their variances
+    for (Standing& standing : standings){
+        double own = standing.win_rate.error / Z_95, first = standings[0].win_rate.error / Z_95;
+        standing.independent_error = Z_95 * std::sqrt(own * own + first * first);
+    }
+
+    return standings;
+}
+
+/*****************************************************************************************************************************************************
+** Estimate estimate(double sum, double sum_sq, long count)
+** The mean of "count" values, and Z_95 standard errors from the sample variance.
+******************************************************************************************************************************************************/
+Tournament::Estimate Tournament::estimate(double sum, double sum_sq, long count){
+    Estimate result = {0.0, 0.0};
+    if (count == 0){
+        return result;
+    }
+    result.mean = sum / count;
+    if (count > 1){
+        double variance = std::max(0.0, (sum_sq - sum * result.mean) / (count - 1));
+        result.error = Z_95 * std::sqrt(variance / count);
+    }
+    return result;
+}
+
+/*****************************************************************************************************************************************************
+** Policy* make_policy(const string& name, unsigned seed)
+******************************************************************************************************************************************************/
+Policy* Tournament::make_policy(const string& name, unsigned seed){
+    if (name == "random"){
+        return new RandomPolicy(seed);
+    }
+    if (name == "wager"){
+        return new WagerPolicy(seed);
+    }
+    if (name == "greedy"){
+        return new GreedyPolicy(seed);
+    }
+    if (name == "cautious"){
+        return new CautiousPolicy(seed);
+    }
+    if (name == "solver"){
+        return new SolverPolicy();
+    }
+    return nullptr;
+}
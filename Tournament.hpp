@@ -0,0 +1,82 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the Tournament class, which compares policies by playing every one of
+** them on the same games. Game number g draws three independent streams from std::seed_seq{seed, g, stream}: one
+** builds its board, one rolls its battles and one seeds the policies' own random choices. Every policy gets the
+** same template, the same pieces in the same places, and the same rolls for its first battle, its second battle and
+** so on, without its moves being correlated with either. The games are split into batches across a work-stealing
+** thread pool.
+
+** Because every policy plays the same games (common random numbers), the luck of the board mostly cancels out of the
+** difference between two policies. Each policy is compared to the first one added by the difference in win rate on
+** each game, whose confidence interval is narrower than comparing two independent win rates would give, so the same
+** precision needs fewer games.
+
+** Confidence intervals are 95%, from the normal approximation.
+******************************************************************************************************************************************************/
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <functional>
+
+#include "Simulation.hpp"
+
+class Tournament
+{
+    public:
+        static const int GAMES_PER_TASK = 256;
+
+        typedef std::function<Policy*(unsigned seed)> Factory;     //Makes a new policy for one game
+
+        //A mean and the half-width of its 95% confidence interval
+            struct Estimate
+            {
+                double mean, error;
+            };
+
+        struct Standing
+        {
+            string   name;
+            long     games;
+            Estimate win_rate, strength, moves;
+            Estimate difference;                //Win rate minus the first policy's, game by game
+            double   independent_error;         //Half-width the difference would have without common random numbers
+        };
+
+    private:
+        struct Entry
+        {
+            string  name;
+            Factory make;
+        };
+
+        //Sums from which the estimates are worked out, kept by each worker thread for each policy
+            struct Tally
+            {
+                long   games;
+                double wins, strength, strength_sq, moves, moves_sq;
+                double difference, difference_sq;
+            };
+
+        const std::vector<MapTemplate>& maps;
+        int starting_strength, max_moves;
+        std::vector<Entry> entries;
+
+        static Estimate estimate(double sum, double sum_sq, long count);
+
+    public:
+        Tournament(const std::vector<MapTemplate>& maps, int starting_strength = 30, int max_moves = 1000);
+
+        void add(const string& name, Factory make);
+
+        //Plays games [0, games) with every policy on "threads" threads (0 for one per hardware thread) and returns
+        //a Standing for each policy, in the order they were added.
+            std::vector<Standing> run(long games, int threads, unsigned seed);
+
+        //Makes one of the policies by name: "random", "wager", "greedy", "cautious" or "solver". Returns nullptr for
+        //any other name.
+            static Policy* make_policy(const string& name, unsigned seed);
+};
+
+#endif
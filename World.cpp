@@ -0,0 +1,405 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the implementation file for the World class.
+******************************************************************************************************************************************************/
+#include "World.hpp"
+#include "Board.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char MAGIC[4] = {'T', 'Q', 'W', 'D'};
+const int HEADER_FIELDS = 7;                        //Magic, version, rows, cols, chunk size, start row, start col
+const int BORDER_CELLS = 4 * World::CHUNK + 4;
+
+/*****************************************************************************************************************************************************
+** Helpers for reading and writing little-endian integers
+******************************************************************************************************************************************************/
+static uint32_t read_uint32(const char* bytes){
+    uint32_t value = 0;
+    for (int index = 3; index >= 0; index--){
+        value = (value << 8) | (unsigned char)bytes[index];
+    }
+    return value;
+}
+
+static void write_uint32(std::ofstream& file, uint32_t value){
+    for (int index = 0; index < 4; index++){
+        file.put(char(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+/*****************************************************************************************************************************************************
+** World(size_t capacity)
+******************************************************************************************************************************************************/
+World::World(size_t capacity){
+    data = nullptr;
+    length = 0;
+    rows = cols = chunk_rows = chunk_cols = 0;
+    start_cell = 0;
+    this->capacity = std::max<size_t>(capacity, 2);     //The chunk the player is in, and the one being moved to
+    loads = evictions = 0;
+}
+
+/*****************************************************************************************************************************************************
+** World(const string& filename, size_t capacity)
+******************************************************************************************************************************************************/
+World::World(const string& filename, size_t capacity){
+    data = nullptr;
+    length = 0;
+    rows = cols = chunk_rows = chunk_cols = 0;
+    start_cell = 0;
+    this->capacity = std::max<size_t>(capacity, 2);
+    loads = evictions = 0;
+
+    if (!open(filename)){
+        throw string("ERROR: Could not open " + filename + "\n");
+    }
+}
+
+World::~World(){
+    close();
+}
+
+/*****************************************************************************************************************************************************
+** bool open(const string& filename)
+** Maps the whole file into memory and checks the header. No chunk is built until a cell in it is needed.
+******************************************************************************************************************************************************/
+bool World::open(const string& filename){
+    close();
+
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < PAGE){
+        ::close(descriptor);
+        throw string("ERROR: " + filename + " is not a world file\n");
+    }
+
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED){
+        return false;
+    }
+
+    data = static_cast<const char*>(mapping);
+    length = info.st_size;
+
+    rows = read_uint32(data + 8);
+    cols = read_uint32(data + 12);
+    int64_t start_row = read_uint32(data + 20), start_col = read_uint32(data + 24);
+    chunk_rows = rows / CHUNK;
+    chunk_cols = cols / CHUNK;
+
+    if (std::memcmp(data, MAGIC, 4) != 0 || read_uint32(data + 4) != VERSION || read_uint32(data + 16) != (uint32_t)CHUNK
+        || rows <= 0 || cols <= 0 || rows % CHUNK || cols % CHUNK || start_row >= rows || start_col >= cols
+        || length < PAGE + (size_t)(rows * cols)){
+        close();
+        throw string("ERROR: " + filename + " is not a world file\n");
+    }
+    start_cell = start_row * cols + start_col;
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** close()
+** Destroys every chunk and unmaps the file.
+******************************************************************************************************************************************************/
+void World::close(){
+    for (Chunk* chunk : recent){
+        destroy(chunk);
+        delete chunk;
+    }
+    recent.clear();
+    built.clear();
+    cleared.clear();
+
+    if (data){
+        munmap(const_cast<char*>(data), length);
+    }
+    data = nullptr;
+    length = 0;
+    rows = cols = chunk_rows = chunk_cols = 0;
+}
+
+/*****************************************************************************************************************************************************
+** Space* getPlayerStart()
+** The start is built as an empty '.' cell, so the player is placed on it here. Otherwise its first move would leave
+** a cell nobody had arrived at, and the count would wrap around and show a player there for good.
+******************************************************************************************************************************************************/
+Space* World::getPlayerStart(){
+    Space* start = materialize(start_cell);
+    if (start->getOccupants() == 0){
+        start->arrive();
+    }
+    return start;
+}
+
+/*****************************************************************************************************************************************************
+** Space* materialize(int64_t cell)
+** Called by the Frontiers on chunk edges, and by getPlayerStart().
+******************************************************************************************************************************************************/
+Space* World::materialize(int64_t cell){
+    //Every Space is constructed at the start of its slot, so the slot's address is the Space's
+    int64_t row = cell / cols, col = cell % cols;
+    Chunk* chunk = load((row / CHUNK) * chunk_cols + col / CHUNK);
+    return reinterpret_cast<Space*>(&chunk->slots[(row % CHUNK) * CHUNK + col % CHUNK]);
+}
+
+/*****************************************************************************************************************************************************
+** Chunk* load(int64_t id)
+** Moves a built chunk to the front of "recent". Otherwise builds it, in the least recently used chunk's memory if
+** "capacity" chunks are already built.
+******************************************************************************************************************************************************/
+World::Chunk* World::load(int64_t id){
+    std::unordered_map<int64_t, Chunk*>::iterator found = built.find(id);
+    if (found != built.end()){
+        recent.splice(recent.begin(), recent, found->second->position);
+        return found->second;
+    }
+
+    Chunk* chunk;
+    if (built.size() >= capacity){
+        chunk = recent.back();
+        recent.pop_back();
+        built.erase(chunk->id);
+        destroy(chunk);
+        evictions++;
+    }
+    else {
+        chunk = new Chunk;
+        chunk->slots.resize(CHUNK * CHUNK);
+        chunk->border.resize(BORDER_CELLS);
+    }
+
+    chunk->id = id;
+    build(chunk);
+    recent.push_front(chunk);
+    chunk->position = recent.begin();
+    built[id] = chunk;
+    loads++;
+    return chunk;
+}
+
+/*****************************************************************************************************************************************************
+** int border_index(int row, int col)
+** The cells just outside a chunk, (row, col) relative to its first cell: the row below it, the row above it, then
+** the columns to its left and right.
+******************************************************************************************************************************************************/
+int World::border_index(int row, int col){
+    if (row < 0){
+        return col + 1;
+    }
+    if (row >= CHUNK){
+        return (CHUNK + 2) + col + 1;
+    }
+    return 2 * (CHUNK + 2) + (col < 0 ? 0 : CHUNK) + row;
+}
+
+/*****************************************************************************************************************************************************
+** build(Chunk* chunk)
+** Constructs every cell of the chunk from the file, a Frontier for each cell just outside it that is still in the
+** world, and links them. Enemies fought before the chunk was last destroyed are built as settlements, and the start
+** is built as a settlement too, since showBoard() finds the player by position rather than by sprite.
+******************************************************************************************************************************************************/
+void World::build(Chunk* chunk){
+    const char* pieces = chunk_data(chunk->id);
+    int64_t first_row = (chunk->id / chunk_cols) * CHUNK, first_col = (chunk->id % chunk_cols) * CHUNK;
+
+    chunk->teleports.clear();
+    for (int index = 0; index < CHUNK * CHUNK; index++){
+        char piece = pieces[index];
+        int64_t cell = (first_row + index / CHUNK) * cols + first_col + index % CHUNK;
+        if (piece == 'x' || (piece == 'e' && cleared.count(cell))){
+            piece = '.';
+        }
+
+        Space* space = Board::construct_cell(piece, &chunk->slots[index]);
+        if (piece == 'O'){
+            chunk->teleports.push_back(space);
+        }
+    }
+
+    //Link the Teleport spaces to each other in pairs. An odd one out leads back to itself.
+    for (size_t index = 0; index < chunk->teleports.size(); index += 2){
+        Space* first = chunk->teleports[index];
+        Space* second = (index + 1 < chunk->teleports.size()) ? chunk->teleports[index + 1] : first;
+        first->set_other_teleport(second);
+        second->set_other_teleport(first);
+    }
+
+    for (int row = -1; row <= CHUNK; row++){
+        for (int col = -1; col <= CHUNK; col++){
+            bool outside = (row < 0 || row >= CHUNK || col < 0 || col >= CHUNK);
+            int64_t world_row = first_row + row, world_col = first_col + col;
+            if (outside && world_row >= 0 && world_row < rows && world_col >= 0 && world_col < cols){
+                new (&chunk->border[border_index(row, col)]) Frontier('.', this, world_row * cols + world_col);
+            }
+        }
+    }
+
+    for (int index = 0; index < CHUNK * CHUNK; index++){
+        Space* space = reinterpret_cast<Space*>(&chunk->slots[index]);
+        int row = index / CHUNK, col = index % CHUNK;
+
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++){
+            int next_row = row + DIRECTIONS[dir].row, next_col = col + DIRECTIONS[dir].col;
+            int64_t world_row = first_row + next_row, world_col = first_col + next_col;
+
+            Space* neighbour = nullptr;
+            if (world_row < 0 || world_row >= rows || world_col < 0 || world_col >= cols){
+                neighbour = nullptr;
+            }
+            else if (next_row < 0 || next_row >= CHUNK || next_col < 0 || next_col >= CHUNK){
+                neighbour = reinterpret_cast<Space*>(&chunk->border[border_index(next_row, next_col)]);
+            }
+            else {
+                neighbour = reinterpret_cast<Space*>(&chunk->slots[next_row * CHUNK + next_col]);
+            }
+            space->setNeighbour(dir, neighbour);
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** destroy(Chunk* chunk)
+** Remembers the enemies that have been fought, destroys every Space in the chunk and tells the operating system
+** that its part of the file can be dropped from memory. The chunk's slots are kept for the next chunk built.
+******************************************************************************************************************************************************/
+void World::destroy(Chunk* chunk){
+    int64_t first_row = (chunk->id / chunk_cols) * CHUNK, first_col = (chunk->id % chunk_cols) * CHUNK;
+
+    for (int index = 0; index < CHUNK * CHUNK; index++){
+        Space* space = reinterpret_cast<Space*>(&chunk->slots[index]);
+        if (space->getType() == ENEMY && static_cast<Enemy*>(space)->fought()){
+            cleared.insert((first_row + index / CHUNK) * cols + first_col + index % CHUNK);
+        }
+        space->~Space();
+    }
+
+    for (int row = -1; row <= CHUNK; row++){
+        for (int col = -1; col <= CHUNK; col++){
+            bool outside = (row < 0 || row >= CHUNK || col < 0 || col >= CHUNK);
+            int64_t world_row = first_row + row, world_col = first_col + col;
+            if (outside && world_row >= 0 && world_row < rows && world_col >= 0 && world_col < cols){
+                reinterpret_cast<Space*>(&chunk->border[border_index(row, col)])->~Space();
+            }
+        }
+    }
+
+    madvise(const_cast<char*>(chunk_data(chunk->id)), CHUNK * CHUNK, MADV_DONTNEED);
+}
+
+/*****************************************************************************************************************************************************
+** bool locate(Space* space, int64_t& row, int64_t& col)
+** A Space belongs to the chunk whose slots its address falls in.
+******************************************************************************************************************************************************/
+bool World::locate(Space* space, int64_t& row, int64_t& col){
+    const char* address = reinterpret_cast<const char*>(space);
+    for (Chunk* chunk : recent){
+        const char* first = reinterpret_cast<const char*>(chunk->slots.data());
+        if (address >= first && address < first + chunk->slots.size() * sizeof(CellSlot)){
+            int index = (address - first) / sizeof(CellSlot);
+            row = (chunk->id / chunk_cols) * CHUNK + index / CHUNK;
+            col = (chunk->id % chunk_cols) * CHUNK + index % CHUNK;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*****************************************************************************************************************************************************
+** char sprite(int64_t row, int64_t col)
+** Taken from the built Space if its chunk is built, otherwise from the file.
+******************************************************************************************************************************************************/
+char World::sprite(int64_t row, int64_t col){
+    int64_t id = (row / CHUNK) * chunk_cols + col / CHUNK;
+    int index = (row % CHUNK) * CHUNK + col % CHUNK;
+
+    std::unordered_map<int64_t, Chunk*>::iterator found = built.find(id);
+    if (found != built.end()){
+        return reinterpret_cast<Space*>(&found->second->slots[index])->getSprite();
+    }
+    return Board::hidden_sprite(chunk_data(id)[index]);
+}
+
+/*****************************************************************************************************************************************************
+** showBoard(std::ostream& out, Space* player, int view_rows, int view_cols)
+** Draws the top row first, as Board::showBoard() does. Only the cells in the viewport are read.
+******************************************************************************************************************************************************/
+void World::showBoard(std::ostream& out, Space* player, int view_rows, int view_cols){
+    int64_t player_row = start_cell / cols, player_col = start_cell % cols;
+    bool found = locate(player, player_row, player_col);
+
+    int64_t bottom = std::max<int64_t>(0, std::min<int64_t>(player_row - view_rows / 2, rows - view_rows));
+    int64_t left = std::max<int64_t>(0, std::min<int64_t>(player_col - view_cols / 2, cols - view_cols));
+    int64_t top = std::min<int64_t>(rows, bottom + view_rows) - 1, right = std::min<int64_t>(cols, left + view_cols) - 1;
+
+    out << "Rows " << bottom << "-" << top << ", columns " << left << "-" << right << " of " << rows << "x" << cols << "\n";
+    for (int64_t row = top; row >= bottom; row--){
+        for (int64_t col = left; col <= right; col++){
+            out << ((found && row == player_row && col == player_col) ? 'x' : sprite(row, col)) << " ";
+        }
+        out << "\n";
+    }
+    out << "\n";
+}
+
+/*****************************************************************************************************************************************************
+** bool write(const string& filename, int64_t rows, int64_t cols, double density, std::default_random_engine& rd)
+** Only one chunk is held in memory at a time. The header is written last, once the start is known.
+******************************************************************************************************************************************************/
+bool World::write(const string& filename, int64_t rows, int64_t cols, double density, std::default_random_engine& rd){
+    rows = std::max<int64_t>(1, (rows + CHUNK - 1) / CHUNK) * CHUNK;
+    cols = std::max<int64_t>(1, (cols + CHUNK - 1) / CHUNK) * CHUNK;
+    int64_t chunk_rows = rows / CHUNK, chunk_cols = cols / CHUNK;
+    int64_t start_chunk = (chunk_rows / 2) * chunk_cols + chunk_cols / 2;
+    int64_t start_row = 0, start_col = 0;
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file << string(PAGE, '\0');
+
+    std::bernoulli_distribution mountain(density);
+    string cells(CHUNK * CHUNK, '.');
+    for (int64_t id = 0; id < chunk_rows * chunk_cols; id++){
+        for (char& cell : cells){
+            cell = mountain(rd) ? 'A' : '.';
+        }
+        string pieces = Board::place_pieces(cells, rd);
+
+        //One start for the whole world, in the middle chunk
+        size_t start = pieces.find('x');
+        if (start != string::npos){
+            if (id == start_chunk){
+                start_row = (id / chunk_cols) * CHUNK + start / CHUNK;
+                start_col = (id % chunk_cols) * CHUNK + start % CHUNK;
+            }
+            else {
+                pieces[start] = '.';
+            }
+        }
+        file.write(pieces.data(), pieces.size());
+    }
+
+    file.seekp(0);
+    file.write(MAGIC, 4);
+    uint32_t header[HEADER_FIELDS - 1] = {VERSION, uint32_t(rows), uint32_t(cols), uint32_t(CHUNK), uint32_t(start_row),
+                                          uint32_t(start_col)};
+    for (uint32_t value : header){
+        write_uint32(file, value);
+    }
+
+    file.close();
+    return !file.fail();
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the interface file for the World class, the board of campaign mode. A world can be far
+** larger than memory. It is stored in a world file, split into square chunks of CHUNK x CHUNK cells, and the file
+** is memory-mapped. Only the chunks the player has visited recently are built as Spaces.
+
+** A chunk is built whole the first time a move reaches it, in slots it reuses from the chunk it replaces, and the
+** least recently used chunk is destroyed once more than "capacity" are built. Cells are linked directly to their
+** neighbours in the same chunk. A neighbour across a chunk edge is a Frontier, which asks the World for the cell
+** on the other side, paging its chunk in if necessary. No Space ever points into another chunk, so destroying a
+** chunk never leaves a dangling pointer. The player is always in the most recently used chunk, so it is never the
+** one destroyed. Enemies that have been fought are remembered when their chunk is destroyed, and come back as
+** plain settlements.
+
+** showBoard() draws a viewport around the player. Cells in chunks that aren't built are drawn from the file.
+
+** File layout (all integers little-endian):
+    - Header:  "TQWD", uint32 version, uint32 rows, uint32 cols, uint32 chunk size, uint32 start row, uint32 start
+               col, padded with zeros to PAGE bytes so every chunk starts on a page boundary
+    - Chunks:  row by row of chunks, each CHUNK x CHUNK layout characters ('A', '.', 'e', 'O', '!', 'x'), row by row
+** Portals are paired in the order they appear within their chunk. rows and cols are whole numbers of chunks.
+******************************************************************************************************************************************************/
+#ifndef WORLD_HPP
+#define WORLD_HPP
+
+#include <cstdint>
+#include <list>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Space.hpp"
+
+class World : private CellSource
+{
+    public:
+        static const int CHUNK = 64;
+        static const uint32_t VERSION = 1;
+        static const int PAGE = 4096;
+
+    private:
+        typedef std::aligned_union<0, Mountain, Teleport, Finish, Enemy, Blank, Frontier>::type CellSlot;
+
+        struct Chunk
+        {
+            int64_t id;                             //chunk row * chunk columns + chunk column
+            std::vector<CellSlot> slots;            //One per cell, row by row
+            std::vector<CellSlot> border;           //One Frontier per cell just outside the chunk, see border_index()
+            std::vector<Space*> teleports;          //Scratch space for pairing the portals
+            std::list<Chunk*>::iterator position;   //Where the chunk is in "recent"
+        };
+
+        const char* data;                           //Start of the memory-mapped file, nullptr if no file is open
+        size_t length;
+        int64_t rows, cols, chunk_rows, chunk_cols;
+        int64_t start_cell;
+
+        size_t capacity;                            //Most chunks built at once
+        std::unordered_map<int64_t, Chunk*> built;  //By chunk id
+        std::list<Chunk*> recent;                   //Most recently used first
+        std::unordered_set<int64_t> cleared;        //Cells of enemies fought in chunks that have since been destroyed
+        long loads, evictions;
+
+        World(const World&);                        //Not copyable: owns the mapping and Frontiers point to it
+        World& operator=(const World&);
+
+        const char* chunk_data(int64_t id) const {return data + PAGE + id * CHUNK * CHUNK;};
+
+        virtual Space* materialize(int64_t cell);
+        Chunk* load(int64_t id);                    //The chunk, built if necessary, and now the most recently used
+        void   build(Chunk* chunk);
+        void   destroy(Chunk* chunk);
+        int    border_index(int row, int col);      //Border slot of the cell at (row, col) relative to the chunk's corner
+
+        char sprite(int64_t row, int64_t col);
+
+    public:
+        explicit World(size_t capacity = 64);
+        World(const string& filename, size_t capacity = 64);    //Throws a string if the file isn't a valid world
+        ~World();
+
+        bool open(const string& filename);          //Returns false if the file can't be opened
+        void close();
+
+        Space* getPlayerStart();                    //Builds the start's chunk and places the player there
+
+        int64_t getRows(){return rows;};
+        int64_t getCols(){return cols;};
+        size_t  getBuiltChunks(){return built.size();};
+        long    getLoads(){return loads;};          //Chunks built since the world was opened
+        long    getEvictions(){return evictions;};  //Chunks destroyed to make room
+
+        //Finds the row and column of a Space in one of the built chunks. Returns false if it isn't in any of them.
+            bool locate(Space* space, int64_t& row, int64_t& col);
+
+        //Draws the "view_rows" x "view_cols" cells around "player", clipped to the edges of the world
+            void showBoard(std::ostream& out, Space* player, int view_rows = 15, int view_cols = 31);
+
+        //Writes a "rows" x "cols" world, rounded up to whole chunks, one chunk at a time. Mountains cover about
+        //"density" of each chunk and the pieces are placed as on a board (see Board::place_pieces()), with a single
+        //start near the middle. Returns false if the file can't be written.
+            static bool write(const string& filename, int64_t rows, int64_t cols, double density,
+                              std::default_random_engine& rd);
+};
+
+#endif
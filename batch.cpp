@@ -0,0 +1,65 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the batch simulator. It plays random games on the templates in "maps.txt"
+** with a BatchSim, all lanes in lockstep on one thread, and reports the win rate of each template and games per
+** second. Running it once with "avx2" and once with "scalar" and the same seed gives the same results.
+
+** Usage: batch.exe [number of games] [lanes] [starting strength] [avx2/scalar] [seed]
+******************************************************************************************************************************************************/
+#include "BatchSim.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    long     num_games = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    int      lanes     = (argc > 2) ? std::atoi(argv[2]) : 256;
+    int      strength  = (argc > 3) ? std::atoi(argv[3]) : 30;
+    string   kernel    = (argc > 4) ? argv[4] : "avx2";
+    unsigned seed      = (argc > 5) ? std::strtoul(argv[5], nullptr, 10) : std::random_device{}();
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    if (maps.empty()){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    try{
+        BatchSim sim(maps, lanes, seed, strength, 1000, (kernel == "scalar") ? BatchSim::SCALAR : BatchSim::AVX2);
+
+        auto start = std::chrono::steady_clock::now();
+        sim.run(num_games);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const std::vector<long>& games = sim.getGames();
+        const std::vector<long>& wins = sim.getWins();
+        long total_wins = 0;
+
+        cout << "Map       Games    Win%\n";
+        for (size_t map = 0; map < maps.size(); map++){
+            total_wins += wins[map];
+            cout << std::fixed << std::setprecision(2)
+            << std::setw(3) << (map + 1)
+            << std::setw(12) << games[map]
+            << std::setw(8) << (games[map] ? 100.0 * wins[map] / games[map] : 0.0) << "\n";
+        }
+
+        cout << "\nKernel:            " << ((sim.getKernel() == BatchSim::AVX2) ? "avx2" : "scalar") << "\n"
+        << "Seed:              " << seed << "\n"
+        << "Games played:      " << num_games << "\n"
+        << "Win rate:          " << (num_games ? 100.0 * total_wins / num_games : 0.0) << "%\n"
+        << "Elapsed seconds:   " << elapsed.count() << "\n"
+        << "Games per second:  " << std::setprecision(0) << (num_games / elapsed.count()) << endl;
+    }
+    catch (string error){
+        cout << error;
+        return 1;
+    }
+
+    return 0;
+}
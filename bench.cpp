@@ -0,0 +1,174 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the microbenchmark suite. It times the code paths a game spends its time in:
+    - board_from_file:       Board(rd), which reads "maps.txt" in choose_map(), places the pieces and builds the cells
+    - board_from_templates:  Board(maps, rd), the same without reading the file
+    - reshuffle:             placing the pieces again and rebuilding the cells of an existing board
+    - populate_board:        rebuilding and linking the cells of an existing board from a filled-in layout
+    - move_player:           one Space::move_player() call, including the interact() of the space moved to
+    - enemy_combat:          one battle in Enemy::interact(), wager chosen by a RandomPolicy
+    - show_board:            showBoard() written to a stream that discards its output
+    - snapshot_encode:       writing a game in progress into a snapshot buffer (see Snapshot.hpp)
+    - snapshot_decode:       restoring a game in progress from a snapshot buffer into an existing board
+** The results are printed and written to a JSON file (see Benchmark.hpp) that can be compared between releases.
+** "make bench" builds the suite and writes "bench.json".
+
+** Usage: bench.exe [JSON file] [name filter] [minimum seconds per benchmark]      (defaults: bench.json "" 0.5)
+******************************************************************************************************************************************************/
+#include "Benchmark.hpp"
+#include "Board.hpp"
+#include "Player.hpp"
+#include "Policy.hpp"
+#include "Snapshot.hpp"
+
+#include <cstdlib>
+#include <new>
+
+const int LAYOUTS = 64;
+const int MOVE_KEYS = 4096;
+
+//Every character written to it is thrown away, so show_board measures building the output and nothing else
+class NullBuffer : public std::streambuf
+{
+    protected:
+        virtual int_type overflow(int_type c){return traits_type::not_eof(c);};
+        virtual std::streamsize xsputn(const char*, std::streamsize count){return count;};
+};
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string json_name   = (argc > 1) ? argv[1] : "bench.json";
+    string filter      = (argc > 2) ? argv[2] : "";
+    double min_seconds = (argc > 3) ? std::atof(argv[3]) : 0.5;
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    if (maps.empty()){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    std::default_random_engine rd(1);
+    RandomPolicy policy(1);
+    NullBuffer null_buffer;
+    std::ostream null_out(&null_buffer);
+
+    //Filled-in layouts of one template, so populate_board doesn't include placing the pieces
+    std::vector<string> layouts;
+    for (int index = 0; index < LAYOUTS; index++){
+        layouts.push_back(Board::place_pieces(maps[0].cells, rd));
+    }
+
+    //Random moves, drawn once so move_player doesn't include drawing them
+    std::vector<char> move_keys(MOVE_KEYS);
+    for (char& key : move_keys){
+        key = DIRECTIONS[std::uniform_int_distribution<int>{0, NUM_DIRECTIONS - 1}(rd)].key;
+    }
+
+    BenchmarkRunner runner;
+
+    runner.add("board_from_file", [&](BenchState& state){
+        while (state.keep_running()){
+            Board board(rd);
+        }
+    });
+
+    runner.add("board_from_templates", [&](BenchState& state){
+        while (state.keep_running()){
+            Board board(maps, rd);
+        }
+    });
+
+    runner.add("reshuffle", [&](BenchState& state){
+        Board board(maps, rd);
+        while (state.keep_running()){
+            board.reshuffle(rd);
+        }
+    });
+
+    runner.add("populate_board", [&](BenchState& state){
+        std::vector<MapTemplate> first(1, maps[0]);
+        Board board(first, rd);
+        long index = 0;
+        while (state.keep_running()){
+            board.load_layout(layouts[index++ % LAYOUTS]);
+        }
+    });
+
+    //The player is strong enough never to run out, so after the first few battles the board stays the same and
+    //every call is a move onto a blank, a portal, a fought enemy, the vault, or a mountain or edge.
+    runner.add("move_player", [&](BenchState& state){
+        Board board(maps, rd);
+        Player player(1 << 30, &policy, &rd);
+        Space* position = board.getPlayerStart();
+        long index = 0;
+        while (state.keep_running()){
+            position = position->move_player(move_keys[index++ % MOVE_KEYS], &player);
+        }
+        state.set_items_processed(state.getIterations());
+    });
+
+    //A fresh enemy and player for every battle, built in place so the only allocation is the key a win adds
+    runner.add("enemy_combat", [&](BenchState& state){
+        alignas(Enemy) unsigned char enemy_slot[sizeof(Enemy)];
+        alignas(Player) unsigned char player_slot[sizeof(Player)];
+        while (state.keep_running()){
+            Enemy* enemy = new (enemy_slot) Enemy('e');
+            Player* player = new (player_slot) Player(30, &policy, &rd);
+            enemy->interact(player);
+            player->~Player();
+            enemy->~Enemy();
+        }
+    });
+
+    runner.add("show_board", [&](BenchState& state){
+        Board board(maps, rd);
+        while (state.keep_running()){
+            board.showBoard(null_out);
+        }
+    });
+
+    //A game a few hundred moves in, so some enemies have been fought
+    runner.add("snapshot_encode", [&](BenchState& state){
+        Board board(maps, rd);
+        Player player(1 << 30, &policy, &rd);
+        Space* position = board.getPlayerStart();
+        for (int move = 0; move < 256; move++){
+            position = position->move_player(move_keys[move], &player);
+        }
+        string buffer;
+        while (state.keep_running()){
+            Snapshot::encode(buffer, board, player, position, rd);
+        }
+        state.set_items_processed(state.getIterations());
+    });
+
+    runner.add("snapshot_decode", [&](BenchState& state){
+        Board board(maps, rd);
+        Player player(1 << 30, &policy, &rd);
+        Space* position = board.getPlayerStart();
+        for (int move = 0; move < 256; move++){
+            position = position->move_player(move_keys[move], &player);
+        }
+        string buffer;
+        Snapshot::encode(buffer, board, player, position, rd);
+        while (state.keep_running()){
+            Snapshot::decode(buffer.data(), buffer.size(), board, player, rd);
+        }
+        state.set_items_processed(state.getIterations());
+    });
+
+    runner.run(filter, min_seconds, cout);
+
+    std::ofstream json(json_name);
+    runner.write_json(json, argv[0]);
+    if (!json){
+        cout << "Could not write " << json_name << endl;
+        return 1;
+    }
+    cout << "\nResults written to " << json_name << endl;
+
+    return 0;
+}
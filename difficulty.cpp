@@ -0,0 +1,154 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the difficulty tool. It draws boards from "maps.txt" the same way the game
+** does and scores each one with a DifficultyCache (see Difficulty.hpp), twice over: the first pass works out the
+** scores of boards that aren't in the cache yet, and the second finds all of them there. It reports the cost of
+** each and how the boards' win rates are spread.
+
+** Given a target win rate, it instead selects that many boards with a BoardSelector and reports how long each
+** selection takes and how close the boards come to the target.
+
+** Usage: difficulty.exe [cache file] [boards] [seed] [target win %]        (defaults: maps.difficulty 500 1, none)
+******************************************************************************************************************************************************/
+#include "Difficulty.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+
+const int BUCKETS = 10;
+const float TOLERANCE = 0.05f;          //How close a selected board must come to the target
+
+int select_boards(DifficultyCache& cache, const std::vector<MapTemplate>& maps, long boards, unsigned seed, float target);
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string   cache_name = (argc > 1) ? argv[1] : "maps.difficulty";
+    long     boards     = (argc > 2) ? std::atol(argv[2]) : 500;
+    unsigned seed       = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 1;
+    float    target     = (argc > 4) ? std::atof(argv[4]) / 100 : -1.0f;
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    if (maps.empty()){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    try{
+        DifficultyCache cache(cache_name);
+        if (target >= 0){
+            return select_boards(cache, maps, boards, seed, target);
+        }
+        uint64_t cached_before = cache.size();
+
+        //Draw every board first, so only scoring is timed
+        std::vector<string> layouts;
+        std::vector<int> rows, cols;
+        std::default_random_engine rd(seed);
+        Board board(maps, rd);
+        for (long index = 0; index < boards; index++){
+            if (index > 0){
+                board.reset(maps, rd);
+            }
+            layouts.push_back(board.getLayout());
+            rows.push_back(board.getRows());
+            cols.push_back(board.getCols());
+        }
+
+        std::vector<Difficulty> scores(boards);
+        double seconds[2];
+        long misses[2];
+        for (int pass = 0; pass < 2; pass++){
+            long misses_before = cache.getMisses();
+            auto start = std::chrono::steady_clock::now();
+            for (long index = 0; index < boards; index++){
+                scores[index] = cache.score(layouts[index], rows[index], cols[index]);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            seconds[pass] = elapsed.count();
+            misses[pass] = cache.getMisses() - misses_before;
+        }
+
+        long histogram[BUCKETS] = {0}, unreachable = 0;
+        double distance = 0, enemies = 0;
+        for (Difficulty& score : scores){
+            histogram[std::min(int(score.win_rate * BUCKETS), BUCKETS - 1)]++;
+            if (score.vault_distance < 0){
+                unreachable++;
+            }
+            else {
+                distance += score.vault_distance;
+            }
+            enemies += score.enemies_in_reach;
+        }
+
+        cout << std::fixed << std::setprecision(2)
+        << "Boards:                    " << boards << "\n"
+        << "Already cached:            " << cached_before << "\n"
+        << "First pass:                " << (boards - misses[0]) << " hits, " << misses[0] << " misses, "
+        << (1e6 * seconds[0] / boards) << " us per board\n"
+        << "Second pass:               " << (boards - misses[1]) << " hits, " << misses[1] << " misses, "
+        << (1e6 * seconds[1] / boards) << " us per board\n"
+        << "Cached now:                " << cache.size() << " of " << cache.capacity() << " slots\n"
+        << "Average vault distance:    " << (boards > unreachable ? distance / (boards - unreachable) : 0.0)
+        << " (" << unreachable << " unreachable)\n"
+        << "Average enemies in reach:  " << (boards ? enemies / boards : 0.0) << "\n\n"
+        << "Win rate      Boards\n";
+        for (int bucket = 0; bucket < BUCKETS; bucket++){
+            cout << std::setw(3) << (100 * bucket / BUCKETS) << "-" << std::setw(3) << (100 * (bucket + 1) / BUCKETS)
+            << "%   " << std::setw(8) << histogram[bucket] << "\n";
+        }
+        cout << std::flush;
+    }
+    catch (string error){
+        cout << error;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************************************************************************************
+** int select_boards(DifficultyCache& cache, const std::vector<MapTemplate>& maps, long boards, unsigned seed, float target)
+******************************************************************************************************************************************************/
+int select_boards(DifficultyCache& cache, const std::vector<MapTemplate>& maps, long boards, unsigned seed, float target){
+    BoardSelector selector(maps, &cache, TOLERANCE);
+    std::default_random_engine rd(seed);
+    Board board(maps, rd);
+
+    std::vector<double> micros;
+    long on_target = 0;
+    double distance = 0;
+    for (long index = 0; index < boards; index++){
+        auto start = std::chrono::steady_clock::now();
+        Difficulty difficulty;
+        bool found = selector.select(board, target, rd, difficulty);
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        micros.push_back(elapsed.count());
+
+        on_target += found;
+        distance += std::abs(difficulty.win_rate - target);
+    }
+    std::sort(micros.begin(), micros.end());
+    double total = 0;
+    for (double time : micros){
+        total += time;
+    }
+
+    cout << std::fixed << std::setprecision(2)
+    << "Boards selected:           " << boards << " at a " << (100 * target) << "% win rate\n"
+    << "Within 5 points:           " << on_target << "\n"
+    << "Average points off:        " << (100 * distance / boards) << "\n"
+    << "Candidates per board:      " << (double(selector.getCandidates()) / boards) << "\n"
+    << "Ruled out early:           " << (100.0 * selector.getRuledOut() / selector.getCandidates()) << "%\n"
+    << "Scored in full per board:  " << (double(selector.getScored()) / boards) << "\n"
+    << "Games per board:           " << (double(selector.getGamesPlayed()) / boards) << "\n"
+    << "Microseconds per board:    " << (total / boards) << " average, " << micros[micros.size() / 2] << " median, "
+    << micros[micros.size() * 99 / 100] << " p99, " << micros.back() << " max" << endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the distance cache builder. It writes the distance matrix of every template
+** in a map pack to a cache file beside the pack (see DistanceCache.hpp), unless an up-to-date one is already there.
+** It then places random boards and compares the cached distances, with each board's portal shortcut, against a
+** breadth-first search on a BitBoard, reporting how often they agree and how long each takes.
+
+** Usage: distances.exe [map pack] [boards to check]        (defaults: maps.pack 10000)
+******************************************************************************************************************************************************/
+#include "DistanceCache.hpp"
+#include "MapPack.hpp"
+#include "BitBoard.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <sys/stat.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/*****************************************************************************************************************************************************
+** search(const BitBoard& board, int from, int* moves)
+** Fills "moves" with the fewest moves from "from" to land on each cell (-1 if it can't be reached), following the
+** game's rules: mountains and edges block, and stepping onto a portal lands on its partner.
+******************************************************************************************************************************************************/
+void search(const BitBoard& board, int from, int* moves){
+    int cells = board.getRows() * board.getCols(), frontier[64], head = 0, tail = 0;
+    std::fill(moves, moves + cells, -1);
+    moves[from] = 0;
+    frontier[tail++] = from;
+
+    while (head < tail){
+        int cell = frontier[head++];
+        for (int dir = 0; dir < BitBoard::NUM_DIRECTIONS; dir++){
+            int next = BitBoard::cell(board.destination(BitBoard::bit(cell), dir));
+            if (moves[next] < 0){
+                moves[next] = moves[cell] + 1;
+                frontier[tail++] = next;
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string pack_name = (argc > 1) ? argv[1] : "maps.pack";
+    long   boards    = (argc > 2) ? std::atol(argv[2]) : 10000;
+    string cache_name = DistanceCache::filename_for(pack_name);
+
+    try{
+        MapPack pack;
+        if (!pack.open(pack_name) || pack.size() == 0){
+            cout << "Could not open " << pack_name << " (see mappack.exe)" << endl;
+            return 1;
+        }
+
+        //Rebuild the cache if it is missing or older than the pack
+        struct stat pack_info, cache_info;
+        stat(pack_name.c_str(), &pack_info);
+        if (stat(cache_name.c_str(), &cache_info) != 0 || cache_info.st_mtime < pack_info.st_mtime){
+            auto start = Clock::now();
+            if (!DistanceCache::write(cache_name, pack)){
+                cout << "Could not write " << cache_name << endl;
+                return 1;
+            }
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+            cout << "Wrote " << cache_name << " (" << pack.size() << " templates) in " << elapsed.count() << " seconds\n";
+        }
+
+        DistanceCache cache(pack, cache_name);
+        std::default_random_engine rd(1);
+
+        long pairs = 0, agree = 0, checked = 0;
+        double lookup_seconds = 0.0, search_seconds = 0.0;
+        volatile long sink = 0;
+        int moves[64];
+
+        for (long count = 0; count < boards; count++){
+            Board board(pack, rd);
+            if (board.getRows() * board.getCols() > 64){
+                continue;
+            }
+            checked++;
+            int cells = board.getRows() * board.getCols();
+            const string& layout = board.getLayout();
+            BitBoard bits(layout, board.getRows(), board.getCols());
+
+            //Every open cell to every enemy and the vault, the targets a player walks towards
+            std::vector<int> sources, targets;
+            for (int cell = 0; cell < cells; cell++){
+                if (layout[cell] != 'A'){
+                    sources.push_back(cell);
+                }
+                if (layout[cell] == 'e' || layout[cell] == '!'){
+                    targets.push_back(cell);
+                }
+            }
+
+            auto start = Clock::now();
+            BoardDistances distances(cache.get(board.getMapId()), layout);
+            long total = 0;
+            for (int from : sources){
+                for (int to : targets){
+                    total += distances.distance(from, to);
+                }
+            }
+            auto middle = Clock::now();
+            for (int from : sources){
+                search(bits, from, moves);
+                for (int to : targets){
+                    total -= moves[to];
+                }
+            }
+            auto end = Clock::now();
+            sink = sink + total;
+
+            lookup_seconds += std::chrono::duration<double>(middle - start).count();
+            search_seconds += std::chrono::duration<double>(end - middle).count();
+
+            for (int from : sources){
+                search(bits, from, moves);
+                for (int to : targets){
+                    pairs++;
+                    agree += (distances.distance(from, to) == moves[to]);
+                }
+            }
+        }
+
+        cout << "Boards checked:        " << checked << "\n"
+        << "Cell pairs compared:   " << pairs << "\n"
+        << "Agreeing with search:  " << (pairs ? 100.0 * agree / pairs : 0.0) << "%\n"
+        << "Cached lookups (s):    " << lookup_seconds << "\n"
+        << "Searches (s):          " << search_seconds << endl;
+    }
+    catch (string error){
+        cout << error;
+        return 1;
+    }
+
+    return 0;
+}
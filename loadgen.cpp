@@ -0,0 +1,205 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the server load generator. It keeps a fixed number of sessions open against
+** a running server.exe, each playing one game with random moves and wagers and then declining to play again. As soon
+** as a session ends, a new one is connected in its place.
+
+** Every reply ends with a prompt, so a client knows the server has finished answering when the text received so far
+** ends with one. The time from sending a line to receiving the whole reply is recorded as that move's latency.
+
+** Usage: loadgen.exe [port or socket path] [concurrent sessions] [seconds]
+******************************************************************************************************************************************************/
+#include "Socket.hpp"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+using std::cout;
+using std::endl;
+using std::string;
+typedef std::chrono::steady_clock Clock;
+
+const int MAX_EVENTS = 256;
+
+//One simulated player
+struct Client
+{
+    int fd;
+    string reply;                       //Text received since the last line was sent
+    Clock::time_point sent;             //When the last line was sent
+    bool declined;                      //True once the client has answered "n" to playing again
+};
+
+/*****************************************************************************************************************************************************
+** ends_with(const string& text, const string& suffix)
+******************************************************************************************************************************************************/
+bool ends_with(const string& text, const string& suffix){
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/*****************************************************************************************************************************************************
+** answer(const string& reply, std::default_random_engine& rd)
+** Returns the line to send in response to a complete reply, or an empty string if the reply isn't finished yet.
+******************************************************************************************************************************************************/
+string answer(const string& reply, std::default_random_engine& rd){
+    if (ends_with(reply, "(y/n) ")){
+        return "n\n";
+    }
+    if (ends_with(reply, "Enter your move: ") || ends_with(reply, "Invalid move. Enter: ")){
+        return string(1, "12346789"[std::uniform_int_distribution<int>{0, 7}(rd)]) + "\n";
+    }
+    if (ends_with(reply, ") ")){
+        size_t limit = reply.rfind("(1 to ");
+        if (limit != string::npos){
+            int enemy_strength = std::atoi(reply.c_str() + limit + 6);
+            return std::to_string(std::uniform_int_distribution<int>{1, enemy_strength}(rd)) + "\n";
+        }
+    }
+    return "";
+}
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string address  = (argc > 1) ? argv[1] : "7777";
+    int    sessions = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    double seconds  = (argc > 3) ? std::atof(argv[3]) : 10.0;
+
+    std::random_device seed_gen{};
+    std::default_random_engine rd(seed_gen());
+
+    int poller = epoll_create1(0);
+    std::vector<Client> clients;
+    std::vector<double> latencies;              //Microseconds, one per move or wager
+    long completed = 0, failed = 0;
+
+    //Opens a new session in slot "slot". Failed connections are retried on the next pass of the loop.
+    auto connect_slot = [&](int slot){
+        Client& client = clients[slot];
+        client.reply.clear();
+        client.declined = false;
+        client.sent = Clock::now();
+        try {
+            client.fd = open_connection(address);
+        }
+        catch (const string& error){
+            client.fd = -1;
+            failed++;
+            return;
+        }
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = slot;
+        epoll_ctl(poller, EPOLL_CTL_ADD, client.fd, &event);
+    };
+
+    clients.resize(sessions);
+    for (int slot = 0; slot < sessions; slot++){
+        connect_slot(slot);
+    }
+
+    epoll_event events[MAX_EVENTS];
+    char buffer[8192];
+    auto start = Clock::now(), deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+    while (Clock::now() < deadline){
+        int ready = epoll_wait(poller, events, MAX_EVENTS, 100);
+
+        for (int index = 0; index < ready; index++){
+            int slot = events[index].data.u32;
+            Client& client = clients[slot];
+
+            bool open = true;
+            while (true){
+                ssize_t count = recv(client.fd, buffer, sizeof(buffer), 0);
+                if (count > 0){
+                    client.reply.append(buffer, count);
+                    continue;
+                }
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+                    break;
+                }
+                if (count < 0 && errno == EINTR){
+                    continue;
+                }
+                open = false;
+                break;
+            }
+
+            //The server closes the connection after the last "n"
+            if (!open){
+                if (client.declined){
+                    completed++;
+                }
+                else {
+                    failed++;
+                }
+                close(client.fd);
+                connect_slot(slot);
+                continue;
+            }
+
+            string line = answer(client.reply, rd);
+            if (line.empty()){
+                continue;
+            }
+
+            auto now = Clock::now();
+            latencies.push_back(std::chrono::duration<double, std::micro>(now - client.sent).count());
+            client.reply.clear();
+            client.sent = now;
+            client.declined = (line == "n\n");
+            send(client.fd, line.data(), line.size(), MSG_NOSIGNAL);
+        }
+
+        //Retry any slot whose connection couldn't be opened
+        for (int slot = 0; slot < sessions; slot++){
+            if (clients[slot].fd < 0){
+                connect_slot(slot);
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    for (Client& client : clients){
+        if (client.fd >= 0){
+            close(client.fd);
+        }
+    }
+    close(poller);
+
+    //The first reply of each session (the opening board) is counted too, as the latency of connecting
+    double p50 = 0.0, p99 = 0.0;
+    if (!latencies.empty()){
+        std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2, latencies.end());
+        p50 = latencies[latencies.size() / 2];
+        std::nth_element(latencies.begin(), latencies.begin() + latencies.size() * 99 / 100, latencies.end());
+        p99 = latencies[latencies.size() * 99 / 100];
+    }
+
+    cout << std::fixed << std::setprecision(0)
+    << "Concurrent sessions:   " << sessions << "\n"
+    << "Sessions completed:    " << completed << "\n"
+    << "Sessions failed:       " << failed << "\n"
+    << "Replies timed:         " << latencies.size() << "\n"
+    << std::setprecision(2)
+    << "Elapsed seconds:       " << elapsed.count() << "\n"
+    << "Sessions per second:   " << (completed / elapsed.count()) << "\n"
+    << "Moves per second:      " << (latencies.size() / elapsed.count()) << "\n"
+    << "p50 latency (us):      " << p50 << "\n"
+    << "p99 latency (us):      " << p99 << endl;
+
+    return 0;
+}
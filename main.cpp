@@ -7,58 +7,213 @@
 #include "menu.hpp"
 #include "Board.hpp"
 #include "Player.hpp"
+#include "Renderer.hpp"
+#include "Metrics.hpp"
+#include "Snapshot.hpp"
+#include "Script.hpp"
+#include "Difficulty.hpp"
 
 #include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
 
-char getMove(string*, int);
-void map_keys(string*, int);
+char getMove(std::ostream&, const char*);
+void map_keys(string*, int, char*);
 void show_intro();
 
 /*****************************************************************************************************************************************************
 ** main()
 ** Calling main allows a game of Treasure Quest to be played.
+
+** During a game, everything is written to a Renderer and reaches the terminal in one write per turn, when the next
+** line of input is read. Pass "--redraw" to keep the board in place and redraw only what changed each turn.
+** Pass "--metrics=FILE" to turn on the instrumentation (see Metrics.hpp) and write it to FILE after every game.
+** Pass "--hints" to have every battle suggest the wager with the best chance of winning (see WagerTable.hpp).
+** Pass "--save=FILE" to save the game to FILE after every move (see Snapshot.hpp). A game saved there is resumed
+** when the next one starts, and the file is removed once the game is over.
+** Pass "--script=FILE" to play from a script of commands instead of the keyboard (see Script.hpp), "-" to read
+** them from standard input. The introduction and the controls dialog are skipped, the default controls are used,
+** and the game ends when the script does. Pass "--seed=N" to make the games the same every time, the Nth game
+** seeded with N + its number.
+** Pass "--difficulty=N" to play boards on which a greedy player loses about N% of its games (see Difficulty.hpp),
+** chosen from the templates in "maps.txt". If none is found in time, the closest one found is played, and the game
+** says so.
 ******************************************************************************************************************************************************/
-int main(){
+int main(int argc, char* argv[]){
     const int NUM_CONTROLS = 8;
     string response = "y";
-    do{
-        show_intro();           //Display the introduction
 
+    bool redraw = false, hints = false;
+    string metrics_file, save_file, script_file;
+    bool seeded = false;
+    unsigned long seed = 0;
+    int difficulty = -1;
+    for (int arg = 1; arg < argc; arg++){
+        if (std::strcmp(argv[arg], "--redraw") == 0){
+            redraw = true;
+        }
+        else if (std::strcmp(argv[arg], "--hints") == 0){
+            hints = true;
+        }
+        else if (std::strncmp(argv[arg], "--metrics=", 10) == 0){
+            metrics_file = argv[arg] + 10;
+            Metrics::enable();
+        }
+        else if (std::strncmp(argv[arg], "--save=", 7) == 0){
+            save_file = argv[arg] + 7;
+        }
+        else if (std::strncmp(argv[arg], "--script=", 9) == 0){
+            script_file = argv[arg] + 9;
+        }
+        else if (std::strncmp(argv[arg], "--seed=", 7) == 0){
+            seed = std::strtoul(argv[arg] + 7, nullptr, 10);
+            seeded = true;
+        }
+        else if (std::strncmp(argv[arg], "--difficulty=", 13) == 0){
+            char* end;
+            difficulty = std::strtol(argv[arg] + 13, &end, 10);
+            if (end == argv[arg] + 13 || *end != '\0' || difficulty < 0 || difficulty > 100){
+                cout << "Difficulty must be an integer between 0 and 100 inclusive" << endl;
+                return 1;
+            }
+        }
+    }
+
+    Renderer renderer(1, redraw);
+    std::ostream& screen = renderer.stream();
+    cin.tie(&screen);           //Reading input writes the frame built so far
+
+    //In script mode, moves, wagers and answers come from the script instead of the keyboard
+    std::unique_ptr<Script> script;
+    std::unique_ptr<ScriptPolicy> script_policy;
+    if (!script_file.empty()){
+        try{
+            script.reset(new Script(script_file));
+        }
+        catch (string error){
+            cout << error;
+            return 1;
+        }
+        script_policy.reset(new ScriptPolicy(*script, screen));
+    }
+
+    //Boards are chosen for their difficulty from the templates in "maps.txt"
+    std::vector<MapTemplate> maps;
+    std::unique_ptr<BoardSelector> selector;
+    if (difficulty >= 0){
+        maps = Board::load_maps();
+        if (maps.empty()){
+            cout << "No maps found in maps.txt" << endl;
+            return 1;
+        }
+        selector.reset(new BoardSelector(maps));
+    }
+
+    unsigned long game = 0;
+    do{
         //Set the game controls
         string key_list[NUM_CONTROLS] = {"1", "2", "3", "4", "6", "7", "8", "9"}, temp;
-        map_keys(key_list, NUM_CONTROLS);
+        char key_moves[256];
+        if (!script){
+            show_intro();       //Display the introduction
+            map_keys(key_list, NUM_CONTROLS, key_moves);
+        }
 
-        Player player(30);      //Initialize Player object with 30 strength points
-        Board game_board;       //Initialize a game board
+        //Every random choice in the game (board layout and battles) comes from this one engine
+        std::default_random_engine rd;
+        std::random_device seed_gen{};
+        rd.seed(seeded ? seed + game++ : seed_gen());
+
+        Player player(30, script_policy.get(), &rd);    //Initialize Player object with 30 strength points
+        player.set_log(&screen);
+        player.set_hints(hints);
+        Board game_board(rd);   //Initialize a game board
+        Difficulty chosen;
+        if (selector && !selector->select(game_board, 1.0f - difficulty / 100.0f, rd, chosen)){
+            screen << "No board of that difficulty was found in time. This one loses about "
+                   << int(100 * (1.0f - chosen.win_rate) + 0.5f) << "% of games.\n";
+        }
 
         //Get the player's starting location and display the player's strength
         Space* current_space = game_board.getPlayerStart();
 
-        do {
-            cout << "---------------------------------------------------------------------------------------\n"
-            << "Player strength: " << player.strength() << "\n"
-            <<"Player Keys: " << player.keys() << "\n" << endl;
-            game_board.showBoard();
+        //Resume a saved game in place of the new one
+        if (!save_file.empty()){
+            try{
+                if (Space* saved = Snapshot::load(save_file, game_board, player, rd)){
+                    current_space = saved;
+                    screen << "Resuming the game saved in " << save_file << "\n";
+                }
+            }
+            catch (string error){
+                screen << error;       //Nothing has been restored, the new game goes ahead
+            }
+        }
+        renderer.invalidate();
 
-            char move = getMove(key_list, NUM_CONTROLS);
+        do {
+            renderer.draw_turn(game_board, player);
+
+            char move;
+            if (script){
+                screen << "Enter your move: ";
+                screen.flush();             //Written once per turn, as when the keyboard is read
+                move = script_policy->choose_move(&game_board, current_space, &player);
+                screen << "\n";
+                if (script_policy->finished()){
+                    break;
+                }
+            }
+            else {
+                move = getMove(screen, key_moves);
+            }
             current_space = current_space->move_player(move, &player);
 
+            if (!save_file.empty()){
+                Snapshot::save(save_file, game_board, player, current_space, rd);
+            }
+
+            if (script && script_policy->finished()){
+                break;                      //The script ended during a battle
+            }
+
         }while((player.status()) && (!player.won_game()));      //If the player still has strength points and
                                                                 //has not won the game, player takes another turn.
-        cout << "------------------------------------------------------------------------------------------\n";
+        if (script && script_policy->finished()){
+            screen.flush();             //The script ended during the game, which ends with it
+            return 0;
+        }
+        screen << "------------------------------------------------------------------------------------------\n";
+
+        if (!save_file.empty()){
+            std::remove(save_file.c_str());
+        }
+
+        Metrics::count(player.won_game() ? Metrics::GAMES_WON : Metrics::GAMES_LOST);
+        if (!metrics_file.empty()){
+            Metrics::write(metrics_file);
+        }
 
         if (player.won_game()){
-            cout << "You win!\n";
+            screen << "You win!\n";
         }
         else {
-            cout << "Game over!\n";
+            screen << "Game over!\n";
         }
 
-        cout << "Would you like to play again? (y/n) ";
+        screen << "Would you like to play again? (y/n) ";
         string acceptable_responses[2] = {"y", "n"},
         error_mes = "Please respond with 'y' or 'n'. Enter: ";
-        ValidateMultChoice(response, acceptable_responses, 2, error_mes);       //See menu.hpp/cpp
-        cout << endl;
+        if (script){
+            response = (script_policy->choose_option("yn", error_mes) == 'y') ? "y" : "n";
+        }
+        else {
+            ValidateMultChoice(response, acceptable_responses, 2, error_mes);   //See menu.hpp/cpp
+        }
+        screen << "\n";
+        screen.flush();
 
     }while(response == "y");
 
@@ -66,30 +221,28 @@ int main(){
 }
 
 /*****************************************************************************************************************************************************
-** getMove(string* controls, const int NUM_CONTROLS)
+** getMove(std::ostream& screen, const char* key_moves)
 ** Prompts the user to input their next move and returns the appropriate character.
 
-** controls - The list of single-character game controls.
-** NUM_CONTROLS - The number of game controls.
+** screen - Where the prompt is written.
+** key_moves - The table built by map_keys(), translating each control key to the default move character
+**             that later functions are expecting. 0 for keys that aren't controls.
 ******************************************************************************************************************************************************/
-char getMove(string* controls, const int NUM_CONTROLS){
+char getMove(std::ostream& screen, const char* key_moves){
+    Metrics::Timer timer(Metrics::INPUT_WAIT);
 
-    string error_mes = "Invalid move. Enter: ", response;
-    cout << "Enter your move: ";
-    ValidateMultChoice(response, controls, NUM_CONTROLS, error_mes);
-    cout << endl;
-
-    vector<string> acceptable_moves = {"1", "2", "3", "4", "6", "7", "8", "9"};
+    string response;
+    screen << "Enter your move: ";
+    getline(cin, response);
 
-    //This loop translates the user's move input to the value that later functions are expecting.
-    //If the user has chosen to use the default controls, the value of "response" does not change.
-    for (int index=0; index < NUM_CONTROLS; index++){
-        if (response == controls[index]){
-            response = acceptable_moves[index];
-        }
+    //A move is a single control key, translated with one table lookup.
+    while (response.length() != 1 || !key_moves[(unsigned char)response[0]]){
+        screen << "Invalid move. Enter: ";
+        getline(cin, response);
     }
+    screen << "\n";
 
-    return response[0];     //Function returns a char, not string.
+    return key_moves[(unsigned char)response[0]];
 }
 
 /*****************************************************************************************************************************************************
@@ -100,8 +253,12 @@ char getMove(string* controls, const int NUM_CONTROLS){
 
 ** The "key_list" parameter is a pointer to an array that holds the game controls. It initially
 ** contains the default controls and will be modified if the user wants to designate custom ones.
+
+** "key_moves" is a 256-entry table, indexed by character, that is filled in once the controls are known.
+** Each control key maps to the default move character for its direction (see DIRECTIONS in Grid.hpp),
+** and every other character maps to 0.
 ******************************************************************************************************************************************************/
-void map_keys(string* key_list, const int NUM_CONTROLS){
+void map_keys(string* key_list, const int NUM_CONTROLS, char* key_moves){
     cout << "This game is designed to be played with the number pad.\n"
     "The controls are as follows:\n\n"
     "Move SW: 1\nMove S:  2\nMove SE: 3\nMove W:  4\n"
@@ -155,6 +312,11 @@ void map_keys(string* key_list, const int NUM_CONTROLS){
         }
         cout << endl;
     }
+
+    std::fill(key_moves, key_moves + 256, 0);
+    for (int index=0; index < NUM_CONTROLS; index++){
+        key_moves[(unsigned char)key_list[index][0]] = DIRECTIONS[index].key;
+    }
 }
 
 void show_intro(){
@@ -0,0 +1,66 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the map generator. It writes a map file in the format read by
+** Board::choose_map() to standard output: the number of templates, then one template per line. Generation
+** statistics are written to standard error so the output can be redirected straight to "maps.txt".
+
+** Usage: mapgen.exe [number of maps] [mountain density] [seed] [strict (0/1)] [rows] [cols] > maps.txt
+** Boards of up to 64 cells can be generated.
+******************************************************************************************************************************************************/
+#include "MapGenerator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    long   num_maps = (argc > 1) ? std::atol(argv[1]) : 1000;
+    double density  = (argc > 2) ? std::atof(argv[2]) : 0.25;
+    unsigned long seed = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : std::random_device{}();
+    bool   strict   = (argc > 4) && std::atoi(argv[4]);
+    int    rows     = (argc > 5) ? std::atoi(argv[5]) : 6;
+    int    cols     = (argc > 6) ? std::atoi(argv[6]) : rows;
+
+    if (rows <= 0 || cols <= 0 || rows * cols > 64){
+        std::cerr << "Boards must have between 1 and 64 cells" << std::endl;
+        return 1;
+    }
+
+    MapGenerator generator(density, seed, strict, rows, cols);
+
+    //Templates are collected into one buffer and written in large blocks
+    const size_t FLUSH_SIZE = 1 << 16;
+    string buffer = std::to_string(num_maps) + "\n";
+    buffer.reserve(FLUSH_SIZE + 64);
+
+    auto start = std::chrono::steady_clock::now();
+    try{
+        for (long map = 0; map < num_maps; map++){
+            buffer += generator.to_template(generator.next());
+            buffer += '\n';
+
+            if (buffer.size() >= FLUSH_SIZE){
+                std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+                buffer.clear();
+            }
+        }
+    }
+    catch (string error){
+        std::cerr << error;
+        return 1;
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    std::fflush(stdout);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr << "Maps generated:    " << num_maps << "\n"
+    << "Layouts rejected:  " << generator.getRejections() << "\n"
+    << "Maps per minute:   " << (long)(60.0 * num_maps / elapsed.count()) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the map pack converter. It reads a text map file (see mapmaker.hpp and
+** mapgen.exe) one line at a time and writes it as a binary map pack (see MapPack.hpp). When "maps.pack" exists,
+** the game chooses its templates from it instead of "maps.txt".
+
+** Usage: mappack.exe [text map file] [map pack]        (defaults: maps.txt maps.pack)
+******************************************************************************************************************************************************/
+#include "MapPack.hpp"
+
+#include <chrono>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string text_name = (argc > 1) ? argv[1] : "maps.txt";
+    string pack_name = (argc > 2) ? argv[2] : "maps.pack";
+
+    std::ifstream text_file(text_name);
+    if (!text_file){
+        cout << "Could not open " << text_name << endl;
+        return 1;
+    }
+
+    MapPackWriter writer(pack_name);
+    if (!writer.good()){
+        cout << "Could not write " << pack_name << endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    long num_maps = 0, converted = 0;
+    text_file >> num_maps;          //First line holds the number of templates
+    text_file.ignore();
+
+    string line;
+    try{
+        while (converted < num_maps && getline(text_file, line)){
+            writer.add(Board::parse_map(line));
+            converted++;
+        }
+    }
+    catch (string error){
+        cout << "Line " << (converted + 2) << ": " << error;
+        return 1;
+    }
+
+    if (!writer.finish()){
+        cout << "Could not write " << pack_name << endl;
+        return 1;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    cout << "Converted " << converted << " templates from " << text_name << " to " << pack_name
+    << " in " << elapsed.count() << " seconds" << endl;
+
+    return 0;
+}
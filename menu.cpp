@@ -6,8 +6,9 @@
 ** and one that checks if an integer response lies within an upper and lower bound.
 ******************************************************************************************************************************************************/
 #include "menu.hpp"
+#include "Metrics.hpp"
 
-bool checkInt(string);                                  //Returns true if passed a string containing only numeric characters
+bool checkInt(const string&);                                  //Returns true if passed a string containing only numeric characters
 
 /*******************************************************************************************************************************************************
 ** A function used to validate multiple choice input. It takes the following parameters:
@@ -16,7 +17,8 @@ bool checkInt(string);                                  //Returns true if passed
 ** num_choices - The number of acceptable choices there are
 ** error_mess - The error message to be displayed when the user gives an invalid response
 *******************************************************************************************************************************************************/
-void ValidateMultChoice(string &response, string *choices, int num_choices, string error_mes){
+void ValidateMultChoice(string &response, const string *choices, int num_choices, const string& error_mes){
+    Metrics::Timer timer(Metrics::INPUT_WAIT);
     bool goodResponse=false;
     do{
         getline(cin, response);
@@ -36,7 +38,7 @@ void ValidateMultChoice(string &response, string *choices, int num_choices, stri
 ** A function used to reset the controls. Validates that the user's input is in the list of acceptable
 ** inputs and then erases it from the list.
 *******************************************************************************************************************************************************/
-string ValidateNewControls(vector<string>& choices, int num_choices, string error_mes){
+string ValidateNewControls(vector<string>& choices, int num_choices, const string& error_mes){
     bool goodResponse=false;
     string response;
     do{
@@ -62,6 +64,7 @@ string ValidateNewControls(vector<string>& choices, int num_choices, string erro
 ** ubound, lbound - The (inclusive) range that the input must fall into.
 *******************************************************************************************************************************************************/
 void ValidateInt(int& final, int lbound, int ubound){
+    Metrics::Timer timer(Metrics::INPUT_WAIT);
     string response; 
     std::istringstream int_stream;
     bool goodResponse = false;
@@ -91,15 +94,15 @@ void ValidateInt(int& final, int lbound, int ubound){
     }while (!goodResponse);
 }
 
-bool checkInt(string el_string){
+bool checkInt(const string& el_string){
     //If the first character is neither a digit nor a negative sign, return false
     if (!isdigit(el_string[0]) && el_string[0] != '-'){           
         return false;
     }
 
     //If any of the remaining characters are non-numeric, return false
-    for (char character : el_string.substr(1, el_string.length())){
-        if (!isdigit(character)){           
+    for (size_t index = 1; index < el_string.length(); index++){
+        if (!isdigit(el_string[index])){
             return false;
         }
     }
@@ -20,6 +20,6 @@ using std::string;
 using std::vector;
 
 void ValidateInt(int& final, int lbound, int ubound);
-void ValidateMultChoice(string &response, string *choices, int num_choices, string error_mes);
-string ValidateNewControls(vector<string>& choices, int num_choices, string error_mes);
+void ValidateMultChoice(string &response, const string *choices, int num_choices, const string& error_mes);
+string ValidateNewControls(vector<string>& choices, int num_choices, const string& error_mes);
 #endif
@@ -0,0 +1,149 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the Monte Carlo difficulty estimator. It shards a large number of headless
+** games across a work-stealing thread pool and reports the win rate of each template in "maps.txt".
+
+** Every worker thread owns a random number engine, seeded once from its own seed, which it uses for board
+** layouts, battle rolls and its policy's decisions. Nothing is shared between workers while games are running;
+** the per-worker tallies are only added together at the end.
+
+** If a metrics file is given, the instrumentation is turned on (see Metrics.hpp) and written to it at the end.
+** The players move at random and wager at random ("random") or from the precomputed table ("wager", see
+** WagerPolicy).
+
+** Usage: montecarlo.exe [number of games] [threads] [starting strength] [metrics file] [random/wager]
+******************************************************************************************************************************************************/
+#include "Simulation.hpp"
+#include "ThreadPool.hpp"
+#include "Metrics.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+
+const int GAMES_PER_TASK = 2048;
+
+//Everything a worker thread touches while playing games. Aligned to a cache line so the random engine, which
+//every game advances, never shares a line with another worker's state.
+struct alignas(64) WorkerState
+{
+    std::default_random_engine rd;
+    Policy* policy;
+    Board* board;                               //Rebuilt in place for every game, see Board::reset()
+    std::vector<long> games, wins;              //Indexed by map id
+    std::vector<long> strength_left;            //Total strength remaining in won games, by map id
+};
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    long num_games = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    int  threads   = (argc > 2) ? std::atoi(argv[2]) : 0;
+    int  strength  = (argc > 3) ? std::atoi(argv[3]) : 30;
+    string metrics_file = (argc > 4) ? argv[4] : "";
+    bool table_wagers = (argc > 5) && string(argv[5]) == "wager";
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    int num_maps = maps.size();
+    if (num_maps == 0){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    if (!metrics_file.empty()){
+        Metrics::enable();
+    }
+
+    ThreadPool pool(threads);
+
+    //Seed every worker independently from a single draw of the random device
+    std::random_device seed_gen{};
+    unsigned base_seed = seed_gen();
+
+    std::vector<WorkerState> workers(pool.size());
+    for (int worker = 0; worker < pool.size(); worker++){
+        std::seed_seq seeds{base_seed, unsigned(worker)};
+        unsigned worker_seeds[2];
+        seeds.generate(worker_seeds, worker_seeds + 2);
+
+        workers[worker].rd.seed(worker_seeds[0]);
+        if (table_wagers){
+            workers[worker].policy = new WagerPolicy(worker_seeds[1]);
+        }
+        else {
+            workers[worker].policy = new RandomPolicy(worker_seeds[1]);
+        }
+        workers[worker].board = new Board(maps, workers[worker].rd);
+        workers[worker].games.assign(num_maps, 0);
+        workers[worker].wins.assign(num_maps, 0);
+        workers[worker].strength_left.assign(num_maps, 0);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (long first = 0; first < num_games; first += GAMES_PER_TASK){
+        long batch = std::min<long>(GAMES_PER_TASK, num_games - first);
+
+        pool.submit([&workers, &maps, batch, strength]{
+            WorkerState& state = workers[ThreadPool::worker_index()];
+
+            for (long game = 0; game < batch; game++){
+                GameResult result = play_headless(state.policy, state.board, maps, state.rd, strength);
+                state.games[result.map_id]++;
+                if (result.won){
+                    state.wins[result.map_id]++;
+                    state.strength_left[result.map_id] += result.strength;
+                }
+            }
+        });
+    }
+    pool.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    //Combine the per-worker tallies
+    std::vector<long> games(num_maps, 0), wins(num_maps, 0), strength_left(num_maps, 0);
+    for (WorkerState& state : workers){
+        for (int map = 0; map < num_maps; map++){
+            games[map] += state.games[map];
+            wins[map] += state.wins[map];
+            strength_left[map] += state.strength_left[map];
+        }
+        delete state.policy;
+        delete state.board;
+    }
+
+    //Find the highest win rate so the histogram bars can be scaled to it
+    double highest = 0.0;
+    for (int map = 0; map < num_maps; map++){
+        if (games[map]){
+            highest = std::max(highest, double(wins[map]) / games[map]);
+        }
+    }
+
+    const int BAR_WIDTH = 50;
+    cout << "Map       Games    Win%   Avg strength left (wins)\n";
+    for (int map = 0; map < num_maps; map++){
+        double rate = games[map] ? double(wins[map]) / games[map] : 0.0;
+        int bar = (highest > 0.0) ? int(BAR_WIDTH * rate / highest + 0.5) : 0;
+
+        cout << std::fixed << std::setprecision(2)
+        << std::setw(3) << (map + 1)
+        << std::setw(12) << games[map]
+        << std::setw(8) << (100.0 * rate)
+        << std::setw(10) << (wins[map] ? double(strength_left[map]) / wins[map] : 0.0)
+        << "   " << string(bar, '#') << "\n";
+    }
+
+    cout << "\nWagers:            " << (table_wagers ? "wager table" : "random") << "\n"
+    << "Threads:           " << pool.size() << "\n"
+    << "Games played:      " << num_games << "\n"
+    << "Elapsed seconds:   " << elapsed.count() << "\n"
+    << "Games per second:  " << std::setprecision(0) << (num_games / elapsed.count()) << endl;
+
+    if (!metrics_file.empty() && !Metrics::write(metrics_file)){
+        cout << "Could not write " << metrics_file << endl;
+    }
+
+    return 0;
+}
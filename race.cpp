@@ -0,0 +1,70 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the race tool. It builds one board from "maps.txt", runs a Race of
+** headless players on it (see Race.hpp) and reports the outcome, how many moves were made per second, and two
+** checks that the shared board stayed consistent: every player is counted on exactly one space, and no enemy was
+** fought more than once.
+
+** Usage: race.exe [players] [threads] [max turns] [starting strength] [seed]      (defaults: 256 0 1000 30 1)
+******************************************************************************************************************************************************/
+#include "Race.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    int      players   = (argc > 1) ? std::atoi(argv[1]) : 256;
+    int      threads   = (argc > 2) ? std::atoi(argv[2]) : 0;
+    long     max_turns = (argc > 3) ? std::atol(argv[3]) : 1000;
+    int      strength  = (argc > 4) ? std::atoi(argv[4]) : 30;
+    unsigned seed      = (argc > 5) ? std::strtoul(argv[5], nullptr, 10) : 1;
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    if (maps.empty()){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    try{
+        std::default_random_engine rd(seed);
+        Board board(maps, rd);
+        Race race(board, players, seed, strength);
+        Race::Result result = race.run(threads, max_turns);
+
+        //Every player should be on exactly one space, and each key should come from a different enemy
+        int counted = 0, enemies = 0, fought = 0;
+        for (int cell = 0; cell < board.getRows() * board.getCols(); cell++){
+            Space* space = board.getCell(cell);
+            counted += space->getOccupants();
+            if (space->getType() == ENEMY){
+                enemies++;
+                fought += static_cast<Enemy*>(space)->fought();
+            }
+        }
+
+        board.showBoard(cout);
+        cout << "\nPlayers:          " << players << " (" << counted << " counted on the board)\n"
+        << "Winner:           " << (result.winner >= 0 ? std::to_string(result.winner) : string("nobody")) << "\n"
+        << "Enemies fought:   " << fought << " of " << enemies << "\n"
+        << "Keys won:         " << result.keys << "\n"
+        << "Out of strength:  " << result.exhausted << "\n"
+        << "Moves:            " << result.moves << "\n"
+        << "Elapsed seconds:  " << result.seconds << "\n"
+        << "Moves per second: " << std::fixed << std::setprecision(0) << (result.moves / result.seconds) << endl;
+
+        if (counted != players || result.keys > fought){
+            cout << "ERROR: The shared board is inconsistent" << endl;
+            return 1;
+        }
+    }
+    catch (string error){
+        cout << error;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the replay tool. In "record" mode it plays headless games with a
+** RandomPolicy and writes each one to a replay file. In "play" mode it re-executes every game in a replay file and
+** reports any whose outcome differs from the recorded one, which is how a rule change is regression-tested.
+
+** Usage: replay.exe record [replay file] [number of games] [first seed]
+**        replay.exe play [replay file]
+******************************************************************************************************************************************************/
+#include "Replay.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string mode     = (argc > 1) ? argv[1] : "";
+    string filename = (argc > 2) ? argv[2] : "games.tqr";
+
+    if (mode != "record" && mode != "play"){
+        cout << "Usage: replay.exe record [replay file] [number of games] [first seed]\n"
+        "       replay.exe play [replay file]" << endl;
+        return 1;
+    }
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    std::default_random_engine setup_rd(1);
+    Board game_board(maps, setup_rd);          //Rebuilt for every game by record_game() and replay_game()
+
+    auto start = std::chrono::steady_clock::now();
+    long games = 0, mismatches = 0;
+
+    if (mode == "record"){
+        long num_games = (argc > 3) ? std::atol(argv[3]) : 100000;
+        uint64_t first_seed = (argc > 4) ? std::strtoull(argv[4], nullptr, 10) : std::random_device{}();
+
+        ReplayWriter writer(filename);
+        RandomPolicy policy(first_seed);
+        for (games = 0; games < num_games; games++){
+            writer.write(record_game(&policy, &game_board, maps, first_seed + games));
+        }
+        if (!writer.good()){
+            cout << "Could not write " << filename << endl;
+            return 1;
+        }
+    }
+    else {
+        try{
+            ReplayReader reader(filename);
+            GameRecord record;
+            while (reader.next(record)){
+                GameResult result = replay_game(record, &game_board, maps);
+                games++;
+
+                if (result.map_id != (int)record.map_id || result.won != record.won
+                    || result.keys != record.keys || result.strength != record.strength){
+                    if (mismatches < 10){
+                        cout << "Game with seed " << record.seed << " no longer matches its recording\n";
+                    }
+                    mismatches++;
+                }
+            }
+        }
+        catch (string error){
+            cout << error;
+            return 1;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    cout << ((mode == "record") ? "Games recorded:    " : "Games replayed:    ") << games << "\n";
+    if (mode == "play"){
+        cout << "Mismatches:        " << mismatches << "\n";
+    }
+    cout << "Elapsed seconds:   " << elapsed.count() << "\n"
+    << "Games per second:  " << (long)(games / elapsed.count()) << endl;
+
+    return mismatches ? 2 : 0;
+}
@@ -0,0 +1,322 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the Treasure Quest server. It hosts many games at once, one GameSession per
+** connection, so the game can be played with any line-based client (e.g. "nc localhost 7777").
+
+** Each event loop thread waits on its own epoll instance. All of them watch the same listening socket, and
+** EPOLLEXCLUSIVE wakes only one loop per new connection; the connection then stays with that loop. A session only
+** runs when a full line of input has arrived for it, and output that can't be written right away is kept until the
+** socket is writable again, so no session ever blocks another. A connection gets one read and LINES_PER_TURN lines
+** each time its loop comes round to it, so a client that never stops sending can't hold the loop, and it isn't read
+** from at all while more than MAX_OUTPUT of its output is waiting to be written.
+
+** If a metrics file is given, the instrumentation is turned on (see Metrics.hpp) and the file is rewritten every
+** second while the server runs.
+
+** Usage: server.exe [port or socket path] [event loops] [metrics file]
+******************************************************************************************************************************************************/
+#include "GameSession.hpp"
+#include "Socket.hpp"
+#include "Metrics.hpp"
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <unordered_map>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#ifndef EPOLLEXCLUSIVE
+#define EPOLLEXCLUSIVE 0
+#endif
+
+const int MAX_EVENTS = 256;
+const size_t MAX_LINE = 4096;           //Longest line a client may send before it is disconnected
+const size_t MAX_OUTPUT = 1 << 16;      //Unwritten output past which a client isn't read from until it catches up
+const int LINES_PER_TURN = 16;          //Lines one connection may play before its loop serves the others
+
+std::atomic<bool> running(true);
+std::atomic<long> sessions_served(0);
+
+//A client connection and the game it is playing
+struct Connection
+{
+    int fd;
+    string input;                       //Received text not yet played
+    string output;                      //Text waiting to be written
+    size_t written;                     //How much of "output" has been written
+    uint32_t watching;                  //Events the fd is registered for
+    bool peer_closed;                   //True once the client has closed its end
+    bool queued;                        //True while it has lines waiting for the loop's next pass
+    GameSession session;
+
+    Connection(int fd, const std::vector<MapTemplate>& maps, unsigned seed) :
+        fd(fd), written(0), watching(0), peer_closed(false), queued(false), session(maps, seed){};
+
+    bool line_waiting() const {return input.find('\n') != string::npos;};
+    size_t unwritten() const {return output.size() - written;};
+
+    //Reading stops while a line is waiting to be played or too much output is, so the input holds at most one
+    //block past MAX_LINE and the output one turn's worth past MAX_OUTPUT.
+    bool can_read() const {return !peer_closed && !session.finished() && unwritten() <= MAX_OUTPUT && !line_waiting();};
+    bool can_play() const {return !session.finished() && unwritten() <= MAX_OUTPUT && line_waiting();};
+};
+
+void stop(int){
+    running = false;
+}
+
+/*****************************************************************************************************************************************************
+** flush_output(Connection& client)
+** Writes as much pending output as the socket will take. Returns false if the connection has failed.
+******************************************************************************************************************************************************/
+bool flush_output(Connection& client){
+    while (client.written < client.output.size()){
+        ssize_t count = send(client.fd, client.output.data() + client.written,
+                             client.output.size() - client.written, MSG_NOSIGNAL);
+        if (count < 0){
+            if (errno == EAGAIN || errno == EWOULDBLOCK){
+                return true;
+            }
+            if (errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+        client.written += count;
+    }
+    client.output.clear();
+    client.written = 0;
+    return true;
+}
+
+/*****************************************************************************************************************************************************
+** read_input(Connection& client)
+** Reads one block, whatever is available of it. Returns false if the connection has failed or the client has sent an
+** overlong line. A client that has closed its end is marked, and its lines already received are still played.
+******************************************************************************************************************************************************/
+bool read_input(Connection& client){
+    char buffer[4096];
+    ssize_t count;
+    do {
+        count = recv(client.fd, buffer, sizeof(buffer), 0);
+    } while (count < 0 && errno == EINTR);
+
+    if (count == 0){
+        client.peer_closed = true;
+        return true;
+    }
+    if (count < 0){
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    client.input.append(buffer, count);
+
+    size_t last = client.input.rfind('\n');
+    return (last == string::npos ? client.input.size() : client.input.size() - last - 1) <= MAX_LINE;
+}
+
+/*****************************************************************************************************************************************************
+** play_lines(Connection& client)
+** Passes up to LINES_PER_TURN complete lines to the session, stopping early if it finishes or its output backs up.
+******************************************************************************************************************************************************/
+void play_lines(Connection& client){
+    for (int lines = 0; lines < LINES_PER_TURN && client.can_play(); lines++){
+        size_t end = client.input.find('\n');
+        client.output += client.session.input(client.input.substr(0, end));
+        client.input.erase(0, end + 1);
+    }
+}
+
+/*****************************************************************************************************************************************************
+** bool serve(Connection& client, uint32_t events)
+** One turn of a connection: a read if epoll reported one and the client may be read from, its waiting lines, and
+** as much output as the socket takes. Returns false once the connection should be closed. A finished session stays
+** open until the end of its last game has been written.
+******************************************************************************************************************************************************/
+bool serve(Connection& client, uint32_t events){
+    if (events & EPOLLERR){
+        return false;
+    }
+    if ((events & (EPOLLIN | EPOLLHUP)) && client.can_read() && !read_input(client)){
+        return false;
+    }
+    play_lines(client);
+
+    if (!flush_output(client)){
+        return false;
+    }
+    if (client.session.finished()){
+        return !client.output.empty();
+    }
+    return !(client.peer_closed && !client.line_waiting());
+}
+
+/*****************************************************************************************************************************************************
+** watch(int poller, Connection& client, int operation)
+** Registers the events the connection needs now: EPOLLIN while it may be read from, EPOLLOUT while output waits.
+******************************************************************************************************************************************************/
+void watch(int poller, Connection& client, int operation){
+    uint32_t wanted = (client.can_read() ? uint32_t(EPOLLIN) : 0u) | (client.output.empty() ? 0u : uint32_t(EPOLLOUT));
+    if (operation == EPOLL_CTL_MOD && wanted == client.watching){
+        return;
+    }
+    client.watching = wanted;
+
+    epoll_event event;
+    event.events = wanted;
+    event.data.fd = client.fd;
+    epoll_ctl(poller, operation, client.fd, &event);
+}
+
+/*****************************************************************************************************************************************************
+** event_loop(int listener, const std::vector<MapTemplate>& maps, unsigned seed)
+** Runs until the server is stopped. Every session started by this loop is seeded from "seed".
+******************************************************************************************************************************************************/
+void event_loop(int listener, const std::vector<MapTemplate>& maps, unsigned seed){
+    std::default_random_engine seeds(seed);
+    std::unordered_map<int, std::unique_ptr<Connection>> clients;
+
+    int poller = epoll_create1(0);
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    event.data.fd = listener;
+    epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event);
+
+    //Connections with lines left over from their last turn. The loop doesn't wait on epoll while there are any.
+    std::vector<int> queued, serving;
+
+    epoll_event events[MAX_EVENTS];
+    while (running){
+        int ready = epoll_wait(poller, events, MAX_EVENTS, queued.empty() ? 200 : 0);
+        serving.swap(queued);
+        queued.clear();
+
+        //Serves one connection for a turn, then closes it or updates what it is watched for
+        auto turn = [&](std::unordered_map<int, std::unique_ptr<Connection>>::iterator found, uint32_t events){
+            Connection& client = *found->second;
+            if (!serve(client, events)){
+                if (client.session.finished()){
+                    sessions_served++;
+                }
+                close(client.fd);
+                clients.erase(found);
+                return;
+            }
+            watch(poller, client, EPOLL_CTL_MOD);
+            if (client.can_play() && !client.queued){
+                client.queued = true;
+                queued.push_back(client.fd);
+            }
+        };
+
+        for (int index = 0; index < ready; index++){
+            int fd = events[index].data.fd;
+
+            //Accept every waiting connection and send each one its first board
+            if (fd == listener){
+                int accepted;
+                while ((accepted = accept(listener, nullptr, nullptr)) >= 0){
+                    set_nonblocking(accepted);
+                    Connection* client = new Connection(accepted, maps, seeds());
+                    clients[accepted].reset(client);
+                    client->output = client->session.start();
+
+                    if (!flush_output(*client)){
+                        close(accepted);
+                        clients.erase(accepted);
+                        continue;
+                    }
+                    watch(poller, *client, EPOLL_CTL_ADD);
+                }
+                continue;
+            }
+
+            auto found = clients.find(fd);
+            if (found != clients.end()){
+                turn(found, events[index].events);
+            }
+        }
+
+        //Then a turn for every connection that still had lines waiting after its last one
+        for (int fd : serving){
+            auto found = clients.find(fd);
+            if (found != clients.end() && found->second->queued){
+                found->second->queued = false;
+                turn(found, 0);
+            }
+        }
+    }
+
+    for (auto& client : clients){
+        close(client.first);
+    }
+    close(poller);
+}
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string address = (argc > 1) ? argv[1] : "7777";
+    int    loops   = (argc > 2) ? std::atoi(argv[2]) : 0;
+    string metrics_file = (argc > 3) ? argv[3] : "";
+    if (loops <= 0){
+        loops = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    if (maps.empty()){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    int listener;
+    try {
+        listener = open_listener(address);
+    }
+    catch (const string& error){
+        cout << error << endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+
+    std::random_device seed_gen{};
+    unsigned base_seed = seed_gen();
+
+    cout << "Listening on " << address << " with " << loops << " event loop(s)" << endl;
+
+    if (!metrics_file.empty()){
+        Metrics::enable();
+    }
+
+    std::vector<std::thread> threads;
+    for (int loop = 0; loop < loops; loop++){
+        std::seed_seq seeds{base_seed, unsigned(loop)};
+        unsigned loop_seed;
+        seeds.generate(&loop_seed, &loop_seed + 1);
+        threads.emplace_back(event_loop, listener, std::cref(maps), loop_seed);
+    }
+
+    while (!metrics_file.empty() && running){
+        Metrics::write(metrics_file);
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+
+    close(listener);
+    if (!metrics_file.empty()){
+        Metrics::write(metrics_file);
+    }
+    cout << "Sessions served: " << sessions_served << endl;
+    return 0;
+}
@@ -0,0 +1,49 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the batch simulator. It plays a large number of headless games of
+** Treasure Quest and reports the win rate and how many games per second were played.
+
+** Usage: simulate.exe [number of games] [starting strength]
+******************************************************************************************************************************************************/
+#include "Simulation.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    long num_games = (argc > 1) ? std::atol(argv[1]) : 100000;
+    int  strength  = (argc > 2) ? std::atoi(argv[2]) : 30;
+
+    //atol() gives 0 for anything that isn't a number, and the averages need at least one game
+    if (num_games <= 0){
+        cout << "Usage: simulate.exe [number of games] [starting strength]\n"
+        "       The number of games must be a positive integer" << endl;
+        return 1;
+    }
+
+    RandomPolicy policy;
+
+    long wins = 0, total_moves = 0, total_keys = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long game = 0; game < num_games; game++){
+        GameResult result = play_headless(&policy, strength);
+        wins += result.won;
+        total_moves += result.moves;
+        total_keys += result.keys;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    cout << "Games played:      " << num_games << "\n"
+    << "Wins:              " << wins << " (" << (100.0 * wins / num_games) << "%)\n"
+    << "Average moves:     " << (double(total_moves) / num_games) << "\n"
+    << "Average keys:      " << (double(total_keys) / num_games) << "\n"
+    << "Elapsed seconds:   " << elapsed.count() << "\n"
+    << "Games per second:  " << (num_games / elapsed.count()) << endl;
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the board solver. For every template in "maps.txt" it places the pieces
+** the same way the Board constructor does, solves each resulting board and reports the best possible win
+** probability along with how long each solve took.
+
+** Usage: solve.exe [boards per template] [starting strength]
+******************************************************************************************************************************************************/
+#include "Board.hpp"
+#include "Solver.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    int boards   = (argc > 1) ? std::atoi(argv[1]) : 100;
+    int strength = (argc > 2) ? std::atoi(argv[2]) : 30;
+
+    std::default_random_engine rd;
+    std::random_device seed_gen{};
+    rd.seed(seed_gen());
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+
+    cout << "Map   Mean win%   Min win%   Max win%   ms/solve   States/solve\n";
+    for (int map = 0; map < (int)maps.size(); map++){
+        if (maps[map].rows * maps[map].cols > 64){         //Larger than a BitBoard can hold
+            continue;
+        }
+
+        double total = 0.0, lowest = 1.0, highest = 0.0;
+        size_t states = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int board = 0; board < boards; board++){
+            Solver solver(BitBoard(Board::place_pieces(maps[map].cells, rd), maps[map].rows, maps[map].cols));
+            double probability = solver.win_probability(strength);
+
+            total += probability;
+            lowest = std::min(lowest, probability);
+            highest = std::max(highest, probability);
+            states += solver.states();
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        cout << std::fixed << std::setprecision(2)
+        << std::setw(3) << (map + 1)
+        << std::setw(12) << (100.0 * total / boards)
+        << std::setw(11) << (100.0 * lowest)
+        << std::setw(11) << (100.0 * highest)
+        << std::setw(11) << (elapsed.count() / boards)
+        << std::setw(15) << (states / boards) << "\n";
+    }
+    cout << endl;
+
+    return 0;
+}
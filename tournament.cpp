@@ -0,0 +1,84 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the tournament tool. It plays every policy listed on the same seeded games
+** from "maps.txt" (see Tournament.hpp) and reports each one's win rate, average strength left and average moves,
+** with 95% confidence intervals, and how its win rate compares with the first policy listed.
+
+** Policies: random   - random moves and wagers (RandomPolicy)
+**           wager    - random moves, wagers from the precomputed table (WagerPolicy)
+**           greedy   - heads for the nearest unexplored cell, then the vault, table wagers (GreedyPolicy)
+**           cautious - moves like greedy, never wagers more than a third of its strength (CautiousPolicy)
+**           solver   - optimal play knowing where every enemy is, an upper bound (SolverPolicy). Solving each board
+**                      takes several milliseconds, so it plays about a hundred games per second per thread.
+
+** Usage: tournament.exe [games] [threads] [policies, comma-separated] [starting strength] [seed]
+**        (defaults: 10000 0 random,wager,greedy,cautious 30 1)
+******************************************************************************************************************************************************/
+#include "Tournament.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    long     games    = (argc > 1) ? std::atol(argv[1]) : 10000;
+    int      threads  = (argc > 2) ? std::atoi(argv[2]) : 0;
+    string   names    = (argc > 3) ? argv[3] : "random,wager,greedy,cautious";
+    int      strength = (argc > 4) ? std::atoi(argv[4]) : 30;
+    unsigned seed     = (argc > 5) ? std::strtoul(argv[5], nullptr, 10) : 1;
+
+    std::vector<MapTemplate> maps = Board::load_maps();
+    if (maps.empty()){
+        cout << "No maps found in maps.txt" << endl;
+        return 1;
+    }
+
+    Tournament tournament(maps, strength);
+    std::vector<string> policies;
+    for (size_t start = 0; start <= names.length(); ){
+        size_t end = names.find(',', start);
+        if (end == string::npos){
+            end = names.length();
+        }
+        string name = names.substr(start, end - start);
+        Policy* test = Tournament::make_policy(name, 0);
+        if (!test){
+            cout << "Unknown policy: " << name << endl;
+            return 1;
+        }
+        delete test;
+
+        policies.push_back(name);
+        tournament.add(name, [name](unsigned game_seed){return Tournament::make_policy(name, game_seed);});
+        start = end + 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Tournament::Standing> standings = tournament.run(games, threads, seed);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    cout << std::fixed << std::setprecision(2)
+    << "Policy           Win%            Strength left    Moves            Win% vs " << policies[0] << "\n";
+    for (Tournament::Standing& standing : standings){
+        cout << std::left << std::setw(10) << standing.name << std::right
+        << std::setw(8) << (100.0 * standing.win_rate.mean) << " +/-" << std::setw(5) << (100.0 * standing.win_rate.error)
+        << std::setw(9) << standing.strength.mean << " +/-" << std::setw(5) << standing.strength.error
+        << std::setw(9) << standing.moves.mean << " +/-" << std::setw(5) << standing.moves.error;
+        if (&standing != &standings[0]){
+            cout << std::setw(9) << std::showpos << (100.0 * standing.difference.mean) << std::noshowpos
+            << " +/-" << std::setw(5) << (100.0 * standing.difference.error)
+            << "  (+/-" << std::setw(5) << (100.0 * standing.independent_error) << " without common random numbers)";
+        }
+        cout << "\n";
+    }
+
+    cout << "\nGames per policy:  " << games << "\n"
+    << "Elapsed seconds:   " << elapsed.count() << "\n"
+    << "Games per second:  " << std::setprecision(0) << (games * standings.size() / elapsed.count()) << endl;
+
+    return 0;
+}
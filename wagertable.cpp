@@ -0,0 +1,150 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the wager table generator. It computes the wager that gives the best
+** chance of winning the game for every battle a player can face, and that chance, and writes the results as
+** constexpr arrays to "WagerTable.hpp", which WagerPolicy and the game's hint mode read at runtime.
+
+** A battle is decided by the enemy's maximum power (6-10), the player's strength points and keys, so the game is
+** reduced to those. Reaching the next enemy costs "enemy moves" strength points and reaching the vault "vault
+** moves", and the player is assumed never to run out of enemies. With W(s, k) the chance of winning from s
+** strength points and k keys, before walking to the next enemy:
+    - W(s, 4) = 1 if s >= vault moves (the last move onto the vault may use up the last point), otherwise 0
+    - W(s, k) = 0 if walking to the enemy leaves no strength points, since there is no battle without any
+    - Otherwise, with t = s - enemy moves, W(s, k) is the average over the enemy's maximum power m of the best
+      wager's value: (w / m) * W(max(t - w, 0) + w / 2, k + 1) + (1 - w / m) * W(max(t - w, 0), k)
+** Losing always leaves fewer points than the player started with, and winning adds a key, so the table is
+** filled in by decreasing keys and increasing strength. Wagers above the player's strength are allowed, as they
+** are in Enemy::interact().
+
+** Under these rules the best wager always turns out to be the enemy's maximum power: it can't lose, and wagering
+** less risks the same points for the same half back. What differs from battle to battle is the chance of winning
+** the game afterwards, which is written as WIN_CHANCE for the hints to show.
+
+** Usage: wagertable.exe [enemy moves] [vault moves] > WagerTable.hpp      (defaults: 2 3)
+******************************************************************************************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+const int MAX_STRENGTH = 60;
+const int MIN_POWER = 6, MAX_POWER = 10, POWERS = MAX_POWER - MIN_POWER + 1;
+const int KEYS_NEEDED = 4;
+
+double win[KEYS_NEEDED + 1][MAX_STRENGTH + 1];                      //W(s, k)
+double battle[POWERS][KEYS_NEEDED][MAX_STRENGTH + 1];               //Chance of winning the game from a battle with t points left
+int    best[POWERS][KEYS_NEEDED][MAX_STRENGTH + 1];
+
+//Strength above the table's range is counted as the top of the range
+double value(int keys, int strength){
+    return win[keys][std::min(strength, MAX_STRENGTH)];
+}
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    int enemy_moves = (argc > 1) ? std::atoi(argv[1]) : 2;
+    int vault_moves = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+    for (int strength = 0; strength <= MAX_STRENGTH; strength++){
+        win[KEYS_NEEDED][strength] = (strength >= vault_moves && strength > 0) ? 1.0 : 0.0;
+    }
+
+    for (int keys = KEYS_NEEDED - 1; keys >= 0; keys--){
+        //Too weak to reach an enemy
+        for (int strength = 0; strength <= std::min(enemy_moves, MAX_STRENGTH); strength++){
+            win[keys][strength] = 0.0;
+        }
+
+        for (int left = 0; left <= MAX_STRENGTH; left++){
+            //A battle with "left" points after walking to the enemy
+            for (int power = MIN_POWER; power <= MAX_POWER; power++){
+                double best_value = -1.0;
+                int best_wager = power;
+                for (int wager = power; wager >= 1 && left > 0; wager--){      //Ties go to the larger, safer wager
+                    int after = std::max(left - wager, 0);
+                    double chance = double(wager) / power;
+                    double outcome = chance * value(keys + 1, after + wager / 2) + (1.0 - chance) * value(keys, after);
+                    if (outcome > best_value + 1e-12){
+                        best_value = outcome;
+                        best_wager = wager;
+                    }
+                }
+                battle[power - MIN_POWER][keys][left] = std::max(best_value, 0.0);
+                best[power - MIN_POWER][keys][left] = best_wager;
+            }
+
+            //Losing leaves fewer than "left" points, so W(left + enemy_moves, keys) only needs what is already known
+            int strength = left + enemy_moves;
+            if (strength <= MAX_STRENGTH){
+                double total = 0.0;
+                for (int power = 0; power < POWERS; power++){
+                    total += battle[power][keys][left];
+                }
+                win[keys][strength] = (left > 0) ? total / POWERS : 0.0;
+            }
+        }
+    }
+
+    std::printf("/*****************************************************************************************************************************************************\n"
+                "** Author: Ignacio Procel\n"
+                "** Date: 12/10/19\n"
+                "** Description: Generated by \"wagertable.exe %d %d\" (see wagertable.cpp). Do not edit.\n"
+                "** The wager with the best chance of winning the game for every battle, and that chance, for a player who needs %d\n"
+                "** strength points to reach each enemy and %d to reach the vault. Indexed by [maximum power - %d], [keys] and\n"
+                "** [strength points left when the battle starts].\n"
+                "******************************************************************************************************************************************************/\n"
+                "#ifndef WAGERTABLE_HPP\n#define WAGERTABLE_HPP\n\n",
+                enemy_moves, vault_moves, enemy_moves, vault_moves, MIN_POWER);
+
+    std::printf("namespace WagerTable\n{\n"
+                "    constexpr int MAX_STRENGTH = %d, MIN_POWER = %d, MAX_POWER = %d, KEYS_NEEDED = %d;\n"
+                "    constexpr int ENEMY_MOVES = %d, VAULT_MOVES = %d;\n\n",
+                MAX_STRENGTH, MIN_POWER, MAX_POWER, KEYS_NEEDED, enemy_moves, vault_moves);
+
+    std::printf("    constexpr unsigned char BEST_WAGER[%d][%d][%d] = {\n", POWERS, KEYS_NEEDED, MAX_STRENGTH + 1);
+    for (int power = 0; power < POWERS; power++){
+        std::printf("        {\n");
+        for (int keys = 0; keys < KEYS_NEEDED; keys++){
+            std::printf("            {");
+            for (int strength = 0; strength <= MAX_STRENGTH; strength++){
+                std::printf("%s%d", strength ? "," : "", best[power][keys][strength]);
+            }
+            std::printf("}%s\n", keys < KEYS_NEEDED - 1 ? "," : "");
+        }
+        std::printf("        }%s\n", power < POWERS - 1 ? "," : "");
+    }
+    std::printf("    };\n\n");
+
+    std::printf("    constexpr float WIN_CHANCE[%d][%d][%d] = {\n", POWERS, KEYS_NEEDED, MAX_STRENGTH + 1);
+    for (int power = 0; power < POWERS; power++){
+        std::printf("        {\n");
+        for (int keys = 0; keys < KEYS_NEEDED; keys++){
+            std::printf("            {");
+            for (int strength = 0; strength <= MAX_STRENGTH; strength++){
+                std::printf("%s%.4ff", strength ? "," : "", battle[power][keys][strength]);
+            }
+            std::printf("}%s\n", keys < KEYS_NEEDED - 1 ? "," : "");
+        }
+        std::printf("        }%s\n", power < POWERS - 1 ? "," : "");
+    }
+    std::printf("    };\n\n");
+
+    std::printf("    //Brings the arguments into the table's range. Strength above it is counted as the top of the range.\n"
+                "        constexpr int clamp(int value, int low, int high){\n"
+                "            return value < low ? low : (value > high ? high : value);\n"
+                "        }\n\n"
+                "    constexpr int best_wager(int power, int keys, int strength){\n"
+                "        return BEST_WAGER[clamp(power, MIN_POWER, MAX_POWER) - MIN_POWER][clamp(keys, 0, KEYS_NEEDED - 1)]\n"
+                "                         [clamp(strength, 0, MAX_STRENGTH)];\n"
+                "    }\n\n"
+                "    //Chance of winning the game from the battle with best_wager()\n"
+                "        constexpr float win_chance(int power, int keys, int strength){\n"
+                "            return WIN_CHANCE[clamp(power, MIN_POWER, MAX_POWER) - MIN_POWER][clamp(keys, 0, KEYS_NEEDED - 1)]\n"
+                "                             [clamp(strength, 0, MAX_STRENGTH)];\n"
+                "        }\n"
+                "}\n\n#endif\n");
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************************************************************************************
+** Author: Ignacio Procel
+** Date: 12/10/19
+** Description: This is the main file for the campaign world tool. In "make" mode it writes a world file (see
+** World.hpp) one chunk at a time, so a world of any size can be generated without holding it in memory. In "walk"
+** mode it opens a world, walks a headless RandomPolicy player across it with a limited number of chunks built at
+** once, and reports how many chunks were paged in and out, along with the viewport around where the walk ended.
+
+** "drift" makes every other move the one given (e.g. 6 for east), so the walk crosses chunks instead of staying
+** near the start.
+
+** Usage: world.exe make [world file] [rows] [cols] [mountain density] [seed]
+**        world.exe walk [world file] [moves] [chunks built at once] [seed] [drift]
+******************************************************************************************************************************************************/
+#include "World.hpp"
+#include "Policy.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+
+/*****************************************************************************************************************************************************
+** main()
+******************************************************************************************************************************************************/
+int main(int argc, char* argv[]){
+    string mode     = (argc > 1) ? argv[1] : "";
+    string filename = (argc > 2) ? argv[2] : "world.tqw";
+
+    if (mode == "make"){
+        int64_t  rows    = (argc > 3) ? std::atoll(argv[3]) : 4096;
+        int64_t  cols    = (argc > 4) ? std::atoll(argv[4]) : rows;
+        double   density = (argc > 5) ? std::atof(argv[5]) : 0.2;
+        unsigned seed    = (argc > 6) ? std::strtoul(argv[6], nullptr, 10) : std::random_device{}();
+
+        std::default_random_engine rd(seed);
+        auto start = std::chrono::steady_clock::now();
+        if (!World::write(filename, rows, cols, density, rd)){
+            cout << "Could not write " << filename << endl;
+            return 1;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        cout << "Wrote " << filename << " in " << elapsed.count() << " seconds" << endl;
+        return 0;
+    }
+
+    if (mode != "walk"){
+        cout << "Usage: world.exe make [world file] [rows] [cols] [mountain density] [seed]\n"
+        "       world.exe walk [world file] [moves] [chunks built at once] [seed] [drift]" << endl;
+        return 1;
+    }
+
+    long     moves    = (argc > 3) ? std::atol(argv[3]) : 1000000;
+    size_t   capacity = (argc > 4) ? std::atol(argv[4]) : 16;
+    unsigned seed     = (argc > 5) ? std::strtoul(argv[5], nullptr, 10) : 1;
+    char     drift    = (argc > 6) ? argv[6][0] : 0;
+
+    try{
+        World world(filename, capacity);
+        std::default_random_engine rd(seed);
+        RandomPolicy policy(seed);
+        Player player(1 << 30, &policy, &rd);      //Strong enough never to run out
+
+        auto start = std::chrono::steady_clock::now();
+        Space* position = world.getPlayerStart();
+        for (long move = 0; move < moves; move++){
+            char key = (drift && move % 2) ? drift : policy.choose_move(nullptr, position, &player);
+            position = position->move_player(key, &player);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        world.showBoard(cout, position);
+        cout << "World:            " << world.getRows() << "x" << world.getCols() << "\n"
+        << "Moves:            " << moves << "\n"
+        << "Keys:             " << player.keys() << (player.won_game() ? " (reached the vault)" : "") << "\n"
+        << "Chunks built:     " << world.getLoads() << "\n"
+        << "Chunks destroyed: " << world.getEvictions() << "\n"
+        << "Chunks in memory: " << world.getBuiltChunks() << " of at most " << capacity << "\n"
+        << "Elapsed seconds:  " << elapsed.count() << "\n"
+        << "Moves per second: " << std::fixed << std::setprecision(0) << (moves / elapsed.count()) << endl;
+    }
+    catch (string error){
+        cout << error;
+        return 1;
+    }
+
+    return 0;
+}